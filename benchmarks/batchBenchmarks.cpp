@@ -0,0 +1,68 @@
+// Throughput of BatchParser as the number of threads grows.
+#include <string>
+#include <thread>
+#include <vector>
+#include "autoArgParse/batchParser.h"
+#include "benchmark.h"
+using namespace std;
+using namespace AutoArgParse;
+
+namespace Benchmarks {
+namespace {
+const size_t NUMBER_FLAGS = 100;
+const size_t FLAGS_PER_LINE = 10;
+const size_t BATCH_SIZE = 10000;
+
+vector<unsigned> threadCounts() {
+    unsigned hardwareThreads = max(1u, thread::hardware_concurrency());
+    vector<unsigned> counts;
+    for (unsigned count = 1; count < hardwareThreads; count *= 2) {
+        counts.push_back(count);
+    }
+    counts.push_back(hardwareThreads);
+    return counts;
+}
+}  // namespace
+
+void runBatchBenchmarks(Suite& suite) {
+    if (!suite.enabled("batch/parse")) {
+        return;
+    }
+    ArgParser parser;
+    vector<string> names;
+    for (size_t i = 0; i < NUMBER_FLAGS; i++) {
+        names.push_back("--flag" + to_string(i));
+        parser.add<ComplexFlag>(names.back(), Policy::OPTIONAL, "A flag.")
+            .add<Arg<int>>("value", Policy::MANDATORY, "An integer.");
+    }
+    // every command line uses a different selection of flags
+    vector<string> strings;
+    strings.reserve(BATCH_SIZE * (FLAGS_PER_LINE * 2 + 1));
+    vector<vector<const char*>> argvs(BATCH_SIZE);
+    for (size_t line = 0; line < BATCH_SIZE; line++) {
+        strings.push_back("benchmark");
+        argvs[line].push_back(strings.back().c_str());
+        for (size_t i = 0; i < FLAGS_PER_LINE; i++) {
+            strings.push_back(names[(line * 31 + i * 7) % NUMBER_FLAGS]);
+            argvs[line].push_back(strings.back().c_str());
+            strings.push_back(to_string(line + i));
+            argvs[line].push_back(strings.back().c_str());
+        }
+    }
+    vector<CommandLine> batch;
+    for (auto& argv : argvs) {
+        batch.push_back(CommandLine{(int)argv.size(), argv.data()});
+    }
+    for (unsigned numberThreads : threadCounts()) {
+        BatchParser batchParser(parser, numberThreads);
+        vector<ParseResults> results;
+        suite.measure("batch/parse",
+                      {{"threads", numberThreads},
+                       {"tokens", FLAGS_PER_LINE * 2}},
+                      BATCH_SIZE, [&]() {
+                          batchParser.parse(batch, results);
+                          sink = results.back().numberTokensParsed;
+                      });
+    }
+}
+}  // namespace Benchmarks
@@ -0,0 +1,108 @@
+#ifndef AUTOARGPARSE_BENCHMARKS_BENCHMARK_H_
+#define AUTOARGPARSE_BENCHMARKS_BENCHMARK_H_
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Benchmarks {
+typedef std::vector<std::pair<std::string, long long>> Params;
+
+struct Result {
+    std::string name;
+    Params params;
+    size_t iterations;
+    double nanosPerIteration;
+    // work items (tokens, flags, conversions) processed per iteration
+    double itemsPerIteration;
+};
+
+/** Write values into this to stop the optimiser from removing the work being
+ * measured.*/
+extern volatile size_t sink;
+
+/**
+ * Runs and records benchmarks.  Every measurement repeats the timed function
+ * until at least `minSeconds` have been spent in it, and always at least
+ * `minIterations` times.  Measurements whose untimed setup is expensive stop
+ * early once ten times `minSeconds` of wall clock time has passed.
+ */
+class Suite {
+    std::vector<Result> results;
+    std::string filter;
+    double minSeconds;
+    size_t minIterations = 3;
+
+    void record(const std::string& name, const Params& params, size_t items,
+                size_t iterations, double totalNanos);
+
+   public:
+    // largest synthetic schema to generate
+    size_t maxFlags;
+
+    Suite(std::string filter, double minSeconds, size_t maxFlags)
+        : filter(std::move(filter)),
+          minSeconds(minSeconds),
+          maxFlags(maxFlags) {}
+
+    inline bool enabled(const std::string& name) const {
+        return name.find(filter) != std::string::npos;
+    }
+
+    /**
+     * Call `setup` (untimed) then `run` on its result (timed) repeatedly.
+     * Use this when `run` consumes or mutates what it is given.
+     */
+    template <typename Setup, typename Run>
+    void measure(const std::string& name, const Params& params, size_t items,
+                 Setup setup, Run run) {
+        if (!enabled(name)) {
+            return;
+        }
+        typedef std::chrono::steady_clock Clock;
+        const auto began = Clock::now();
+        double totalNanos = 0;
+        double wallNanos = 0;
+        size_t iterations = 0;
+        // setup may dominate, so also stop after a multiple of minSeconds
+        while (iterations < minIterations ||
+               (totalNanos < minSeconds * 1e9 &&
+                wallNanos < 10 * minSeconds * 1e9)) {
+            auto state = setup();
+            auto start = Clock::now();
+            run(state);
+            auto end = Clock::now();
+            totalNanos +=
+                std::chrono::duration<double, std::nano>(end - start).count();
+            wallNanos =
+                std::chrono::duration<double, std::nano>(end - began).count();
+            ++iterations;
+        }
+        record(name, params, items, iterations, totalNanos);
+    }
+
+    /** Measure `run` without any per iteration setup. */
+    template <typename Run>
+    void measure(const std::string& name, const Params& params, size_t items,
+                 Run run) {
+        measure(name, params, items, [] { return 0; },
+                [&run](int) { run(); });
+    }
+
+    void writeJson(std::ostream& os, const std::string& version) const;
+};
+
+/** Powers of ten from `from` up to and including `to`. */
+std::vector<size_t> decades(size_t from, size_t to);
+
+void runConverterBenchmarks(Suite& suite);
+void runParserBenchmarks(Suite& suite);
+void runStaticSchemaBenchmarks(Suite& suite);
+void runBatchBenchmarks(Suite& suite);
+void runResponseFileBenchmarks(Suite& suite);
+void runLazyArgBenchmarks(Suite& suite);
+void runConcurrentConversionBenchmarks(Suite& suite);
+void runMappedFileBenchmarks(Suite& suite);
+}  // namespace Benchmarks
+#endif /* AUTOARGPARSE_BENCHMARKS_BENCHMARK_H_ */
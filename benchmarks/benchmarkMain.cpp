@@ -0,0 +1,109 @@
+#include <fstream>
+#include <iostream>
+#include "autoArgParse/argParser.h"
+#include "benchmark.h"
+using namespace std;
+using namespace AutoArgParse;
+
+ArgParser argParser;
+
+auto& outputPath =
+    argParser
+        .add<ComplexFlag>("--output", Policy::OPTIONAL,
+                          "Write the results as JSON to a file rather than "
+                          "standard output.")
+        .add<Arg<string>>("path", Policy::MANDATORY, "Output file.");
+
+auto& filter =
+    argParser
+        .add<ComplexFlag>("--filter", Policy::OPTIONAL,
+                          "Only run benchmarks whose name contains a string.")
+        .add<Arg<string>>("substring", Policy::MANDATORY, "Name filter.");
+
+auto& minTime =
+    argParser
+        .add<ComplexFlag>("--min-time", Policy::OPTIONAL,
+                          "Minimum time spent measuring each case, default "
+                          "0.2 seconds.")
+        .add<Arg<double>>("seconds", Policy::MANDATORY, "Time in seconds.");
+
+auto& maxFlags =
+    argParser
+        .add<ComplexFlag>("--max-flags", Policy::OPTIONAL,
+                          "Largest synthetic schema to generate, default "
+                          "100000 flags.")
+        .add<Arg<size_t>>("number_flags", Policy::MANDATORY,
+                          "Number of flags.");
+
+namespace Benchmarks {
+volatile size_t sink = 0;
+
+void Suite::record(const std::string& name, const Params& params,
+                   size_t items, size_t iterations, double totalNanos) {
+    results.push_back(
+        Result{name, params, iterations, totalNanos / iterations,
+               static_cast<double>(items)});
+    const Result& result = results.back();
+    cerr << result.name;
+    for (const auto& param : result.params) {
+        cerr << " " << param.first << "=" << param.second;
+    }
+    cerr << ": " << result.nanosPerIteration << " ns";
+    if (items > 1) {
+        cerr << " (" << result.nanosPerIteration / items << " ns/item)";
+    }
+    cerr << endl;
+}
+
+void Suite::writeJson(std::ostream& os, const std::string& version) const {
+    os << "{\n  \"library\": \"autoArgParse\",\n  \"version\": \"" << version
+       << "\",\n  \"results\": [";
+    bool first = true;
+    for (const auto& result : results) {
+        os << ((first) ? "\n" : ",\n");
+        first = false;
+        os << "    {\"name\": \"" << result.name << "\", \"params\": {";
+        bool firstParam = true;
+        for (const auto& param : result.params) {
+            os << ((firstParam) ? "" : ", ") << "\"" << param.first
+               << "\": " << param.second;
+            firstParam = false;
+        }
+        os << "}, \"iterations\": " << result.iterations
+           << ", \"ns_per_iteration\": " << result.nanosPerIteration
+           << ", \"items_per_iteration\": " << result.itemsPerIteration
+           << ", \"ns_per_item\": "
+           << result.nanosPerIteration / result.itemsPerIteration << "}";
+    }
+    os << "\n  ]\n}\n";
+}
+
+std::vector<size_t> decades(size_t from, size_t to) {
+    std::vector<size_t> values;
+    for (size_t value = from; value <= to; value *= 10) {
+        values.push_back(value);
+    }
+    return values;
+}
+}  // namespace Benchmarks
+
+int main(const int argc, const char** argv) {
+    argParser.validateArgs(argc, argv);
+    Benchmarks::Suite suite((filter) ? filter.get() : "",
+                            (minTime) ? minTime.get() : 0.2,
+                            (maxFlags) ? maxFlags.get() : 100000);
+    Benchmarks::runConverterBenchmarks(suite);
+    Benchmarks::runParserBenchmarks(suite);
+    Benchmarks::runStaticSchemaBenchmarks(suite);
+    Benchmarks::runBatchBenchmarks(suite);
+    Benchmarks::runResponseFileBenchmarks(suite);
+    Benchmarks::runLazyArgBenchmarks(suite);
+    Benchmarks::runConcurrentConversionBenchmarks(suite);
+    Benchmarks::runMappedFileBenchmarks(suite);
+    if (outputPath) {
+        ofstream os(outputPath.get());
+        suite.writeJson(os, AUTOARGPARSE_VERSION);
+    } else {
+        suite.writeJson(cout, AUTOARGPARSE_VERSION);
+    }
+}
@@ -0,0 +1,54 @@
+// Concurrent conversion: lists of files opened one after another while
+// parsing against on a ConversionPool once the run has been matched.
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "autoArgParse/argParser.h"
+#include "benchmark.h"
+using namespace std;
+using namespace AutoArgParse;
+
+namespace Benchmarks {
+namespace {
+/** An empty file that is deleted again when it goes out of scope.*/
+struct TemporaryFile {
+    string path;
+    TemporaryFile() : path("autoArgParse-benchmark-concurrent.txt") {
+        ofstream os(path);
+    }
+    ~TemporaryFile() { remove(path.c_str()); }
+};
+
+void measureFileList(Suite& suite, const string& name, ConversionPool* pool,
+                     vector<const char*>& argv) {
+    ArgParser parser;
+    parser.convertConcurrently(pool);
+    parser.add<ArgList<ifstream>>("file", Policy::MANDATORY, "Files to read.");
+    size_t numberFiles = argv.size() - 1;
+    size_t numberThreads = (pool) ? pool->numberThreads() : 1;
+    ParseResults results;
+    suite.measure(name, {{"files", (long long)numberFiles},
+                         {"threads", (long long)numberThreads}},
+                  numberFiles, [&]() {
+                      parser.parseArgs((int)argv.size(), argv.data(), results);
+                      sink = results.numberTokensParsed;
+                  });
+}
+}  // namespace
+
+void runConcurrentConversionBenchmarks(Suite& suite) {
+    TemporaryFile file;
+    ConversionPool pool(max(4u, thread::hardware_concurrency()));
+    for (size_t numberFiles : {10, 200, 1000}) {
+        if (numberFiles > suite.maxFlags) {
+            continue;
+        }
+        vector<const char*> argv(numberFiles + 1, file.path.c_str());
+        argv[0] = "benchmark";
+        measureFileList(suite, "concurrent/sequential", NULL, argv);
+        measureFileList(suite, "concurrent/pool", &pool, argv);
+    }
+}
+}  // namespace Benchmarks
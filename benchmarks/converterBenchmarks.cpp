@@ -0,0 +1,58 @@
+// Converter throughput, the dedicated number converters against the
+// istringstream based StreamConverter they replaced.
+#include <random>
+#include <string>
+#include <vector>
+#include "autoArgParse/argParser.h"
+#include "benchmark.h"
+using namespace std;
+using namespace AutoArgParse;
+
+namespace Benchmarks {
+namespace {
+const size_t NUMBER_TOKENS = 100000;
+
+template <typename Convert>
+void measureConversions(Suite& suite, const string& name,
+                        const vector<StringView>& tokens, Convert convert) {
+    suite.measure(name, {{"tokens", tokens.size()}}, tokens.size(), [&]() {
+        size_t checksum = 0;
+        for (const auto& token : tokens) {
+            checksum += static_cast<size_t>(convert(token));
+        }
+        sink = checksum;
+    });
+}
+}  // namespace
+
+void runConverterBenchmarks(Suite& suite) {
+    mt19937 rng(42);
+    vector<string> ints, doubles;
+    uniform_int_distribution<int> intDist(-1000000000, 1000000000);
+    uniform_real_distribution<double> doubleDist(-1e6, 1e6);
+    for (size_t i = 0; i < NUMBER_TOKENS; i++) {
+        ints.emplace_back(to_string(intDist(rng)));
+        doubles.emplace_back(to_string(doubleDist(rng)));
+    }
+    vector<StringView> intTokens(ints.begin(), ints.end());
+    vector<StringView> doubleTokens(doubles.begin(), doubles.end());
+    measureConversions(suite, "convert/int/stream", intTokens,
+                       StreamConverter<int>());
+    measureConversions(suite, "convert/int", intTokens, Converter<int>());
+    measureConversions(suite, "convert/int64/stream", intTokens,
+                       StreamConverter<long long>());
+    measureConversions(suite, "convert/int64", intTokens,
+                       Converter<long long>());
+    measureConversions(suite, "convert/double/stream", doubleTokens,
+                       StreamConverter<double>());
+    measureConversions(suite, "convert/double", doubleTokens,
+                       Converter<double>());
+    measureConversions(suite, "convert/int/range", intTokens,
+                       chain(Converter<int>(),
+                             IntRange(-1000000000, 1000000000, true, true)));
+    measureConversions(suite, "convert/string", intTokens,
+                       [](StringView token) {
+                           return Converter<string>()(token).size();
+                       });
+}
+}  // namespace Benchmarks
@@ -0,0 +1,51 @@
+// Lazy args: validating command lines naming files, opening every file while
+// parsing against deferring it to the first get().
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "autoArgParse/argParser.h"
+#include "benchmark.h"
+using namespace std;
+using namespace AutoArgParse;
+
+namespace Benchmarks {
+namespace {
+/** An empty file that is deleted again when it goes out of scope.*/
+struct TemporaryFile {
+    string path;
+    TemporaryFile() : path("autoArgParse-benchmark-lazy.txt") {
+        ofstream os(path);
+    }
+    ~TemporaryFile() { remove(path.c_str()); }
+};
+
+template <template <class, class> class ArgType>
+void measureFileArgs(Suite& suite, const string& name, size_t numberFiles,
+                     vector<const char*>& argv) {
+    ArgParser parser;
+    for (size_t i = 0; i < numberFiles; i++) {
+        parser.add<ArgType<ifstream, FakeDoNothingConverter<ifstream>>>(
+            "file", Policy::MANDATORY, "A file to read.");
+    }
+    ParseResults results;
+    suite.measure(name, {{"files", numberFiles}}, numberFiles, [&]() {
+        parser.parseArgs((int)argv.size(), argv.data(), results);
+        sink = results.numberTokensParsed;
+    });
+}
+}  // namespace
+
+void runLazyArgBenchmarks(Suite& suite) {
+    TemporaryFile file;
+    for (size_t numberFiles : {1, 10, 100}) {
+        if (numberFiles > suite.maxFlags) {
+            continue;
+        }
+        vector<const char*> argv(numberFiles + 1, file.path.c_str());
+        argv[0] = "benchmark";
+        measureFileArgs<Arg>(suite, "lazy/eager", numberFiles, argv);
+        measureFileArgs<LazyArg>(suite, "lazy/deferred", numberFiles, argv);
+    }
+}
+}  // namespace Benchmarks
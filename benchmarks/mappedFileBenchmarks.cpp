@@ -0,0 +1,74 @@
+// File arguments: validating a command line naming a large input and reading
+// every byte of it, through Arg<std::ifstream> and through Arg<MappedFile>.
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "autoArgParse/argParser.h"
+#include "benchmark.h"
+using namespace std;
+using namespace AutoArgParse;
+
+namespace Benchmarks {
+namespace {
+/** A file of `size` bytes that is deleted again when it goes out of scope.*/
+struct TemporaryFile {
+    string path;
+    explicit TemporaryFile(size_t size)
+        : path("autoArgParse-benchmark-mapped.bin") {
+        ofstream os(path, ios::binary);
+        string block(1 << 16, 'x');
+        for (size_t written = 0; written < size; written += block.size()) {
+            os.write(block.data(), min(block.size(), size - written));
+        }
+    }
+    ~TemporaryFile() { remove(path.c_str()); }
+};
+
+size_t checksum(const char* first, const char* last) {
+    size_t sum = 0;
+    for (; first != last; ++first) {
+        sum += (unsigned char)*first;
+    }
+    return sum;
+}
+
+void measureIfstream(Suite& suite, size_t size, vector<const char*>& argv) {
+    ArgParser parser;
+    auto& input =
+        parser.add<Arg<ifstream>>("input", Policy::MANDATORY, "File to read.");
+    ParseResults results;
+    vector<char> buffer(1 << 16);
+    suite.measure("mappedfile/ifstream", {{"bytes", (long long)size}}, size, [&]() {
+        parser.parseArgs((int)argv.size(), argv.data(), results);
+        ifstream& is = input.get(results);
+        size_t sum = 0;
+        while (is.read(buffer.data(), buffer.size()) || is.gcount() > 0) {
+            sum += checksum(buffer.data(), buffer.data() + is.gcount());
+        }
+        sink = sum;
+    });
+}
+
+void measureMappedFile(Suite& suite, size_t size, vector<const char*>& argv) {
+    ArgParser parser;
+    auto& input = parser.add<Arg<MappedFile>>("input", Policy::MANDATORY,
+                                              "File to read.");
+    ParseResults results;
+    suite.measure("mappedfile/mmap", {{"bytes", (long long)size}}, size, [&]() {
+        parser.parseArgs((int)argv.size(), argv.data(), results);
+        const MappedFile& file = input.get(results);
+        sink = checksum(file.begin(), file.end());
+    });
+}
+}  // namespace
+
+void runMappedFileBenchmarks(Suite& suite) {
+    for (size_t size : {1 << 12, 1 << 20, 1 << 26}) {
+        TemporaryFile file(size);
+        vector<const char*> argv = {"benchmark", file.path.c_str()};
+        measureIfstream(suite, size, argv);
+        measureMappedFile(suite, size, argv);
+    }
+}
+}  // namespace Benchmarks
@@ -0,0 +1,637 @@
+// Schema construction, validation and help rendering over synthetic schemas.
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "autoArgParse/argParser.h"
+#include "autoArgParse/parseException.h"
+#include "benchmark.h"
+using namespace std;
+using namespace AutoArgParse;
+
+namespace Benchmarks {
+namespace {
+typedef unique_ptr<ArgParser> ParserPtr;
+
+/** Owns the strings behind a synthetic argv. */
+struct CommandLine {
+    vector<string> strings;
+    vector<const char*> argv;
+
+    CommandLine(vector<string> tokens) : strings(std::move(tokens)) {
+        strings.insert(strings.begin(), "benchmark");
+        for (const auto& token : strings) {
+            argv.push_back(token.c_str());
+        }
+    }
+    inline int argc() const { return (int)argv.size(); }
+};
+
+vector<string> flagNames(size_t numberFlags) {
+    vector<string> names;
+    names.reserve(numberFlags);
+    for (size_t i = 0; i < numberFlags; i++) {
+        names.push_back("--flag" + to_string(i));
+    }
+    return names;
+}
+
+/** Flat schema, every flag is optional and takes one integer. */
+ParserPtr makeFlatParser(const vector<string>& names) {
+    ParserPtr parser(new ArgParser());
+    for (const auto& name : names) {
+        parser
+            ->add<ComplexFlag>(name, Policy::OPTIONAL, "A synthetic flag.")
+            .add<Arg<int>>("value", Policy::MANDATORY, "An integer.");
+    }
+    return parser;
+}
+
+/** Chain of nested flags --level0 --level1 ... ending with an integer.*/
+ParserPtr makeNestedParser(size_t depth) {
+    ParserPtr parser(new ArgParser());
+    ComplexFlag<DoNothingTrigger>* flag = &parser->add<ComplexFlag>(
+        "--level0", Policy::OPTIONAL, "Nesting level 0.");
+    for (size_t i = 1; i < depth; i++) {
+        flag = &flag->add<ComplexFlag>("--level" + to_string(i),
+                                       Policy::OPTIONAL, "Nesting level.");
+    }
+    flag->add<Arg<int>>("value", Policy::MANDATORY, "An integer.");
+    return parser;
+}
+
+void validate(ArgParser& parser, CommandLine& commandLine) {
+    parser.validateArgs(commandLine.argc(), commandLine.argv.data(), false);
+    sink = parser.getNumberArgsSuccessfullyParsed();
+}
+
+void benchmarkConstruction(Suite& suite) {
+    for (size_t numberFlags : decades(10, suite.maxFlags)) {
+        vector<string> names = flagNames(numberFlags);
+        suite.measure("schema/construct", {{"flags", numberFlags}},
+                      numberFlags, [&]() {
+                          ParserPtr parser = makeFlatParser(names);
+                          sink = parser->getArgs().size();
+                      });
+    }
+}
+
+void benchmarkValidation(Suite& suite) {
+    for (size_t numberFlags : decades(10, suite.maxFlags)) {
+        vector<string> names = flagNames(numberFlags);
+        for (size_t numberUsed : decades(1, numberFlags)) {
+            vector<string> tokens;
+            for (size_t i = 0; i < numberUsed; i++) {
+                tokens.push_back(names[(i * 7919) % numberFlags]);
+                tokens.push_back(to_string(i));
+            }
+            // a flag may only be given once
+            if ((7919 % numberFlags) == 0 && numberUsed > 1) {
+                continue;
+            }
+            CommandLine commandLine(std::move(tokens));
+            suite.measure(
+                "parse/flat",
+                {{"flags", numberFlags}, {"tokens", commandLine.argc() - 1}},
+                commandLine.argc() - 1, [&]() { return makeFlatParser(names); },
+                [&](ParserPtr& parser) { validate(*parser, commandLine); });
+        }
+    }
+}
+
+/** Steady state of a long lived parser validating one command line after
+ * another, the reset between parses is part of the measurement.*/
+void benchmarkReuse(Suite& suite) {
+    for (size_t numberFlags : decades(10, suite.maxFlags)) {
+        vector<string> names = flagNames(numberFlags);
+        ParserPtr parser = makeFlatParser(names);
+        for (size_t numberUsed : {1, 10}) {
+            if (numberUsed > numberFlags) {
+                continue;
+            }
+            vector<string> tokens;
+            for (size_t i = 0; i < numberUsed; i++) {
+                tokens.push_back(names[(i * 7919) % numberFlags]);
+                tokens.push_back(to_string(i));
+            }
+            CommandLine commandLine(std::move(tokens));
+            suite.measure(
+                "parse/reuse",
+                {{"flags", numberFlags}, {"tokens", commandLine.argc() - 1}},
+                commandLine.argc() - 1,
+                [&]() { validate(*parser, commandLine); });
+        }
+    }
+}
+
+/** Rejected command lines (an unknown token after a valid flag), reported
+ * through the results or as a thrown ParseException.*/
+void benchmarkRejection(Suite& suite) {
+    for (size_t numberFlags : decades(10, suite.maxFlags)) {
+        vector<string> names = flagNames(numberFlags);
+        ParserPtr parser = makeFlatParser(names);
+        CommandLine commandLine({names[0], "1", "--unknown"});
+        suite.measure("parse/rejected", {{"flags", numberFlags}}, 1, [&]() {
+            const ParseResults& results = parser->tryValidateArgs(
+                commandLine.argc(), commandLine.argv.data());
+            sink = results.failure.tokenIndex;
+        });
+        suite.measure("parse/rejected/throwing", {{"flags", numberFlags}}, 1,
+                      [&]() {
+                          try {
+                              validate(*parser, commandLine);
+                          } catch (ParseException& e) {
+                              sink = e.errorMessage.size();
+                          }
+                      });
+    }
+}
+
+void benchmarkNesting(Suite& suite) {
+    for (size_t depth : {1, 2, 5, 10, 20, 50}) {
+        vector<string> tokens;
+        for (size_t i = 0; i < depth; i++) {
+            tokens.push_back("--level" + to_string(i));
+        }
+        tokens.push_back("42");
+        CommandLine commandLine(std::move(tokens));
+        suite.measure("parse/nested", {{"depth", depth}}, depth,
+                      [&]() { return makeNestedParser(depth); },
+                      [&](ParserPtr& parser) { validate(*parser, commandLine); });
+    }
+}
+
+/**
+ * A tool -> group -> resource -> verb like tree `depth` levels deep, each
+ * level holding the subcommands list, create and get, the path going through
+ * get.  With `sharedNames` every level uses those names, otherwise each
+ * level has names of its own.
+ */
+ParserPtr makeDispatchParser(size_t depth, bool sharedNames) {
+    ParserPtr parser(new ArgParser());
+    ComplexFlag<DoNothingTrigger>* level = parser.get();
+    for (size_t i = 0; i < depth; i++) {
+        string suffix = (sharedNames) ? "" : to_string(i);
+        level->add<ComplexFlag>("list" + suffix, Policy::OPTIONAL, "List.");
+        level->add<ComplexFlag>("create" + suffix, Policy::OPTIONAL,
+                                "Create.");
+        level = &level->add<ComplexFlag>("get" + suffix, Policy::OPTIONAL,
+                                         "Get.");
+    }
+    level->add<Arg<int>>("value", Policy::MANDATORY, "An integer.");
+    return parser;
+}
+
+/** Parsing the whole path of makeDispatchParser(), the time per level
+ * should not grow with depth. */
+void benchmarkDispatch(Suite& suite) {
+    for (bool sharedNames : {false, true}) {
+        for (size_t depth : {1, 2, 5, 10, 20, 50}) {
+            ParserPtr parser = makeDispatchParser(depth, sharedNames);
+            vector<string> tokens;
+            for (size_t i = 0; i < depth; i++) {
+                tokens.push_back((sharedNames) ? "get" : "get" + to_string(i));
+            }
+            tokens.push_back("42");
+            CommandLine commandLine(std::move(tokens));
+            ParseResults results;
+            suite.measure("dispatch/path",
+                          {{"depth", depth}, {"shared_names", sharedNames}},
+                          depth, [&]() {
+                              parser->parseArgs(commandLine.argc(),
+                                                commandLine.argv.data(),
+                                                results);
+                              sink = results.numberTokensParsed;
+                          });
+        }
+    }
+}
+
+/** Positional values, one ArgList against as many single Args.*/
+void benchmarkPositional(Suite& suite) {
+    for (size_t numberValues : decades(10, suite.maxFlags * 10)) {
+        vector<string> tokens;
+        for (size_t i = 0; i < numberValues; i++) {
+            tokens.push_back(to_string(i));
+        }
+        CommandLine commandLine(std::move(tokens));
+        ArgParser listParser;
+        listParser.add<ArgList<int>>("values", Policy::MANDATORY, "Integers.");
+        ParseResults results;
+        suite.measure("positional/list", {{"tokens", numberValues}},
+                      numberValues, [&]() {
+                          listParser.parseArgs(commandLine.argc(),
+                                               commandLine.argv.data(),
+                                               results);
+                          sink = results.numberTokensParsed;
+                      });
+        if (numberValues > suite.maxFlags) {
+            continue;
+        }
+        ArgParser argsParser;
+        for (size_t i = 0; i < numberValues; i++) {
+            argsParser.add<Arg<int>>("value", Policy::MANDATORY, "An integer.");
+        }
+        ParseResults argsResults;
+        suite.measure("positional/args", {{"tokens", numberValues}},
+                      numberValues, [&]() {
+                          argsParser.parseArgs(commandLine.argc(),
+                                               commandLine.argv.data(),
+                                               argsResults);
+                          sink = argsResults.numberTokensParsed;
+                      });
+    }
+}
+
+/**
+ * Million token command lines mixing flags and values that look like flags:
+ * 64 options --flagN taking an integer, then negative integers collected by
+ * a list, every one starting with '-' as the flags do.
+ */
+void benchmarkMixedTokens(Suite& suite) {
+    const size_t numberFlags = 64;
+    ParserPtr parser = makeFlatParser(flagNames(numberFlags));
+    parser->add<ArgList<int>>("values", Policy::MANDATORY, "Integers.");
+    for (size_t numberTokens : decades(1000, suite.maxFlags * 10)) {
+        vector<string> tokens;
+        for (size_t i = 0; i < numberFlags; i++) {
+            tokens.push_back("--flag" + to_string(i));
+            tokens.push_back(to_string(i));
+        }
+        while (tokens.size() < numberTokens) {
+            tokens.push_back("-" + to_string(tokens.size()));
+        }
+        CommandLine commandLine(std::move(tokens));
+        ParseResults results;
+        suite.measure("tokens/mixed", {{"tokens", numberTokens}}, numberTokens,
+                      [&]() {
+                          parser->parseArgs(commandLine.argc(),
+                                            commandLine.argv.data(), results);
+                          sink = results.numberTokensParsed;
+                      });
+    }
+}
+
+/**
+ * Flag lookup on positional heavy command lines: every value goes through
+ * the flags before an arg takes it.  Values are as long as the flags, so
+ * only what the lookup does with their characters can reject them.
+ */
+void benchmarkFlagLookup(Suite& suite) {
+    const size_t numberValues = 1000;
+    for (size_t numberFlags : {4, 60, 1000}) {
+        if (numberFlags > suite.maxFlags) {
+            continue;
+        }
+        ArgParser parser;
+        for (const auto& name : flagNames(numberFlags)) {
+            parser.add<Flag>(name, Policy::OPTIONAL, "A synthetic flag.");
+        }
+        parser.add<ArgList<StringView>>("values", Policy::MANDATORY,
+                                        "Values.");
+        for (size_t i = 0; i < 3; i++) {
+            parser.add<Arg<StringView>>("value", Policy::MANDATORY, "Value.");
+        }
+        vector<string> tokens;
+        for (size_t i = 0; i < numberValues; i++) {
+            tokens.push_back("val" + to_string(i));
+        }
+        // values also land in single args, which try the flags first
+        tokens.push_back("--flag0");
+        for (size_t i = 0; i < 3; i++) {
+            tokens.push_back("val" + to_string(i));
+        }
+        CommandLine commandLine(std::move(tokens));
+        ParseResults results;
+        suite.measure("flaglookup/values", {{"flags", numberFlags}},
+                      numberValues, [&]() {
+                          parser.parseArgs(commandLine.argc(),
+                                           commandLine.argv.data(), results);
+                          sink = results.numberTokensParsed;
+                      });
+        vector<string> flags = flagNames(numberFlags);
+        CommandLine flagLine(flags);
+        suite.measure("flaglookup/flags", {{"flags", numberFlags}},
+                      numberFlags, [&]() {
+                          parser.parseArgs(flagLine.argc(),
+                                           flagLine.argv.data(), results);
+                          sink = results.numberTokensParsed;
+                      });
+    }
+}
+
+/** Generated CLI: subcommands cmd0 cmd1 ... each with its own options, as
+ * many flags in total as `numberSubcommands` * (options + 1).*/
+ParserPtr makeSubcommandParser(size_t numberSubcommands, size_t options) {
+    ParserPtr parser(new ArgParser());
+    for (size_t i = 0; i < numberSubcommands; i++) {
+        auto& subcommand = parser->add<ComplexFlag>(
+            "cmd" + to_string(i), Policy::OPTIONAL, "A subcommand.");
+        for (size_t j = 0; j < options; j++) {
+            subcommand
+                .add<ComplexFlag>("--option" + to_string(j), Policy::OPTIONAL,
+                                  "An option.")
+                .add<Arg<int>>("value", Policy::MANDATORY, "An integer.");
+        }
+    }
+    return parser;
+}
+
+/**
+ * Parsing a generated CLI before and after ArgParser::freeze(), the memory
+ * held by the schema is reported as the schema_bytes parameter.
+ */
+void benchmarkFrozen(Suite& suite) {
+    const size_t options = 8;
+    for (size_t numberSubcommands : decades(10, suite.maxFlags / options)) {
+        ParserPtr parser = makeSubcommandParser(numberSubcommands, options);
+        vector<string> tokens = {"cmd" + to_string(numberSubcommands / 2)};
+        for (size_t j = 0; j < options; j++) {
+            tokens.push_back("--option" + to_string(j));
+            tokens.push_back(to_string(j));
+        }
+        CommandLine commandLine(std::move(tokens));
+        ParseResults results;
+        for (bool frozen : {false, true}) {
+            if (frozen) {
+                parser->freeze();
+            }
+            suite.measure("frozen/parse",
+                          {{"subcommands", numberSubcommands},
+                           {"frozen", frozen},
+                           {"schema_bytes", parser->schemaBytesUsed()}},
+                          commandLine.argc() - 1, [&]() {
+                              parser->parseArgs(commandLine.argc(),
+                                                commandLine.argv.data(),
+                                                results);
+                              sink = results.numberTokensParsed;
+                          });
+        }
+    }
+}
+
+/**
+ * Start up, building a generated CLI and parsing one command line, with the
+ * schema added flag by flag and loaded from an in memory image made by
+ * ArgParser::saveSchema().  The bindings are made on every start up too.
+ */
+void benchmarkSchemaImage(Suite& suite) {
+    const size_t options = 8;
+    for (size_t numberSubcommands : decades(10, suite.maxFlags / options)) {
+        vector<string> tokens = {"cmd" + to_string(numberSubcommands / 2),
+                                 "--option0", "0"};
+        CommandLine commandLine(std::move(tokens));
+        std::ostringstream os;
+        makeSubcommandParser(numberSubcommands, options)
+            ->saveSchema(os, SchemaBindings().arg<Arg<int>>("int"));
+        const string image = os.str();
+        for (bool loaded : {false, true}) {
+            suite.measure(
+                "schema/startup",
+                {{"subcommands", numberSubcommands},
+                 {"loaded", loaded},
+                 {"image_bytes", image.size()}},
+                numberSubcommands, [&]() {
+                    ParserPtr parser;
+                    if (loaded) {
+                        parser.reset(new ArgParser(false));
+                        parser->loadSchema(
+                            image, SchemaBindings().arg<Arg<int>>("int"));
+                    } else {
+                        parser = makeSubcommandParser(numberSubcommands,
+                                                      options);
+                    }
+                    parser->validateArgs(commandLine.argc(),
+                                         commandLine.argv.data(), false);
+                    sink = parser->getNumberArgsSuccessfullyParsed();
+                });
+        }
+    }
+}
+
+/** makeSubcommandParser() with each subcommand added as a LazyFlag. */
+ParserPtr makeLazySubcommandParser(size_t numberSubcommands, size_t options) {
+    ParserPtr parser(new ArgParser());
+    for (size_t i = 0; i < numberSubcommands; i++) {
+        parser->add<LazyFlag>(
+            "cmd" + to_string(i), Policy::OPTIONAL, "A subcommand.",
+            [options](ComplexFlag<DoNothingTrigger>& subcommand) {
+                for (size_t j = 0; j < options; j++) {
+                    subcommand
+                        .add<ComplexFlag>("--option" + to_string(j),
+                                          Policy::OPTIONAL, "An option.")
+                        .add<Arg<int>>("value", Policy::MANDATORY,
+                                       "An integer.");
+                }
+            });
+    }
+    return parser;
+}
+
+/**
+ * Start up with every subcommand built against subcommands added as
+ * LazyFlags, building the parser and parsing one command line entering one
+ * subcommand.  The memory the schema then holds is the schema_bytes
+ * parameter.
+ */
+void benchmarkLazySubcommands(Suite& suite) {
+    const size_t options = 8;
+    for (size_t numberSubcommands : decades(10, suite.maxFlags / options)) {
+        CommandLine commandLine({"cmd" + to_string(numberSubcommands / 2),
+                                 "--option0", "0"});
+        for (bool lazy : {false, true}) {
+            auto make = (lazy) ? makeLazySubcommandParser : makeSubcommandParser;
+            ParserPtr parsed = make(numberSubcommands, options);
+            parsed->validateArgs(commandLine.argc(), commandLine.argv.data(),
+                                 false);
+            suite.measure("lazy/startup",
+                          {{"subcommands", numberSubcommands},
+                           {"lazy", lazy},
+                           {"schema_bytes", parsed->schemaBytesUsed()}},
+                          numberSubcommands, [&]() {
+                              ParserPtr parser =
+                                  make(numberSubcommands, options);
+                              parser->validateArgs(commandLine.argc(),
+                                                   commandLine.argv.data(),
+                                                   false);
+                              sink = parser->getNumberArgsSuccessfullyParsed();
+                          });
+        }
+    }
+}
+
+/** Short flags -a ... -z and -A ... -Z, and --option0 ... taking an integer,
+ * the command line sets `numberFlags` of each, one token per flag and value
+ * or combined into clusters and --option=value tokens.*/
+CommandLine combinedCommandLine(size_t numberFlags, bool combined) {
+    vector<string> tokens;
+    string cluster = "-";
+    for (size_t i = 0; i < numberFlags; i++) {
+        char c = (char)((i < 26) ? 'a' + i : 'A' + (i - 26));
+        if (combined) {
+            cluster += c;
+        } else {
+            tokens.push_back(string("-") + c);
+        }
+    }
+    if (combined) {
+        tokens.push_back(cluster);
+    }
+    for (size_t i = 0; i < numberFlags; i++) {
+        string option = "--option" + to_string(i);
+        if (combined) {
+            tokens.push_back(option + "=" + to_string(i));
+        } else {
+            tokens.push_back(option);
+            tokens.push_back(to_string(i));
+        }
+    }
+    return CommandLine(std::move(tokens));
+}
+
+/**
+ * Splitting combined flags (see ArgParser::expandCombinedFlags()) against
+ * the same flags given as separate tokens, with the splitting enabled or not.
+ */
+void benchmarkCombinedFlags(Suite& suite) {
+    const size_t maxShortFlags = 52;
+    for (size_t numberFlags : {4, 16, 52}) {
+        if (numberFlags > suite.maxFlags || numberFlags > maxShortFlags) {
+            continue;
+        }
+        ArgParser parser;
+        for (size_t i = 0; i < numberFlags; i++) {
+            char c = (char)((i < 26) ? 'a' + i : 'A' + (i - 26));
+            parser.add<Flag>(string("-") + c, Policy::OPTIONAL, "A flag.");
+            parser
+                .add<ComplexFlag>("--option" + to_string(i), Policy::OPTIONAL,
+                                  "An option.")
+                .add<Arg<int>>("value", Policy::MANDATORY, "An integer.");
+        }
+        ParseResults results;
+        for (int form = 0; form < 3; form++) {
+            bool expanded = form > 0, combined = form > 1;
+            parser.expandCombinedFlags(expanded);
+            CommandLine commandLine = combinedCommandLine(numberFlags, combined);
+            suite.measure("combined/parse",
+                          {{"flags", numberFlags * 2},
+                           {"expanded", expanded},
+                           {"combined", combined}},
+                          numberFlags * 2, [&]() {
+                              parser.parseArgs(commandLine.argc(),
+                                               commandLine.argv.data(),
+                                               results);
+                              sink = results.numberTokensParsed;
+                          });
+        }
+    }
+}
+
+/** Only reports rejected tokens by throwing, as converters did before
+ * tryConvert().*/
+struct ThrowingIntConverter {
+    int operator()(StringView token) const { return Converter<int>()(token); }
+};
+
+template <typename ConverterFunc>
+void measureRejections(Suite& suite, const string& name, size_t numberArgs,
+                       CommandLine& commandLine) {
+    ArgParser parser;
+    for (size_t i = 0; i < numberArgs; i++) {
+        parser.add<Arg<int>>("number", Policy::OPTIONAL, "An integer.",
+                             ConverterFunc());
+    }
+    for (size_t i = 0; i < numberArgs; i++) {
+        parser.add<Arg<StringView>>("word", Policy::MANDATORY, "A word.");
+    }
+    ParseResults results;
+    // every word is offered to each optional number first
+    size_t rejections = numberArgs * (numberArgs + 1) / 2;
+    suite.measure(name, {{"args", numberArgs}}, rejections, [&]() {
+        parser.parseArgs(commandLine.argc(), commandLine.argv.data(), results);
+        sink = results.numberTokensParsed;
+    });
+}
+
+/** Optional positional args turning tokens down, through tryConvert() and
+ * through a converter that throws.*/
+void benchmarkRejectedArgs(Suite& suite) {
+    for (size_t numberArgs : {1, 10, 100}) {
+        if (numberArgs > suite.maxFlags) {
+            continue;
+        }
+        CommandLine commandLine(vector<string>(numberArgs, "word"));
+        measureRejections<Converter<int>>(suite, "positional/rejected",
+                                          numberArgs, commandLine);
+        measureRejections<ThrowingIntConverter>(
+            suite, "positional/rejected/throwing", numberArgs, commandLine);
+    }
+}
+
+void benchmarkExclusiveGroups(Suite& suite) {
+    for (size_t groupSize : {2, 16, 128, 1024}) {
+        if (groupSize > suite.maxFlags) {
+            continue;
+        }
+        vector<string> names;
+        for (size_t i = 0; i < groupSize; i++) {
+            names.push_back("choice" + to_string(i));
+        }
+        CommandLine commandLine({names.back()});
+        suite.measure(
+            "parse/exclusive", {{"group_size", groupSize}}, 1,
+            [&]() {
+                ParserPtr parser(new ArgParser());
+                auto& group = parser->makeExclusiveGroup(Policy::MANDATORY);
+                for (const auto& name : names) {
+                    group.add<Flag>(name, "");
+                }
+                return parser;
+            },
+            [&](ParserPtr& parser) { validate(*parser, commandLine); });
+    }
+}
+
+/** Rendering usage the first time, wrapped or not, then printing it again
+ * from the cache.*/
+void benchmarkHelp(Suite& suite) {
+    for (size_t numberFlags : decades(10, suite.maxFlags)) {
+        vector<string> names = flagNames(numberFlags);
+        for (size_t width : {0, 80}) {
+            suite.measure(
+                "help/render", {{"flags", numberFlags}, {"width", width}},
+                numberFlags, [&]() { return makeFlatParser(names); },
+                [&](ParserPtr& parser) {
+                    sink = parser->usageInfo("benchmark", width).size();
+                });
+        }
+        ParserPtr parser = makeFlatParser(names);
+        suite.measure("help/print_all", {{"flags", numberFlags}}, numberFlags,
+                      [&]() {
+                          ostringstream os;
+                          parser->printAllUsageInfo(os, "benchmark");
+                          sink = os.str().size();
+                      });
+    }
+}
+}  // namespace
+
+void runParserBenchmarks(Suite& suite) {
+    benchmarkConstruction(suite);
+    benchmarkValidation(suite);
+    benchmarkReuse(suite);
+    benchmarkRejection(suite);
+    benchmarkNesting(suite);
+    benchmarkDispatch(suite);
+    benchmarkPositional(suite);
+    benchmarkMixedTokens(suite);
+    benchmarkFlagLookup(suite);
+    benchmarkFrozen(suite);
+    benchmarkSchemaImage(suite);
+    benchmarkLazySubcommands(suite);
+    benchmarkCombinedFlags(suite);
+    benchmarkRejectedArgs(suite);
+    benchmarkExclusiveGroups(suite);
+    benchmarkHelp(suite);
+}
+}  // namespace Benchmarks
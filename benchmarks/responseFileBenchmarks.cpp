@@ -0,0 +1,99 @@
+// Response files: tokenising mapped files, and validating a command line read
+// from a response file against the same command line given as argv.
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "autoArgParse/argParser.h"
+#include "benchmark.h"
+using namespace std;
+using namespace AutoArgParse;
+
+namespace Benchmarks {
+namespace {
+/** A response file that is deleted again when it goes out of scope.*/
+struct TemporaryFile {
+    string path;
+    TemporaryFile(const string& name, const vector<string>& tokens)
+        : path("autoArgParse-benchmark-" + name + ".rsp") {
+        ofstream os(path);
+        for (const auto& token : tokens) {
+            os << token << "\n";
+        }
+    }
+    ~TemporaryFile() { remove(path.c_str()); }
+};
+
+/** Every flag takes one integer, `numberFlags` flags give twice as many
+ * tokens.*/
+vector<string> makeTokens(size_t numberFlags, bool quoted) {
+    vector<string> tokens;
+    for (size_t i = 0; i < numberFlags; i++) {
+        tokens.push_back("--flag" + to_string(i));
+        tokens.push_back((quoted) ? "\"" + to_string(i) + "\""
+                                  : to_string(i));
+    }
+    return tokens;
+}
+
+void benchmarkTokenizer(Suite& suite) {
+    for (size_t numberTokens : decades(1000, suite.maxFlags * 10)) {
+        for (bool quoted : {false, true}) {
+            TemporaryFile file("tokenize",
+                               makeTokens(numberTokens / 2, quoted));
+            suite.measure("responsefile/tokenize",
+                          {{"tokens", numberTokens}, {"quoted", quoted}},
+                          numberTokens, [&]() {
+                              MappedFile mapping(file.path);
+                              ResponseFileTokenizer tokenizer(mapping.data(),
+                                                              mapping.size());
+                              StringView token;
+                              size_t count = 0;
+                              while (tokenizer.next(token)) {
+                                  ++count;
+                              }
+                              sink = count;
+                          });
+        }
+    }
+}
+
+void benchmarkValidation(Suite& suite) {
+    for (size_t numberFlags : decades(10, suite.maxFlags)) {
+        vector<string> tokens = makeTokens(numberFlags, false);
+        ArgParser parser;
+        parser.expandResponseFiles();
+        for (size_t i = 0; i < numberFlags; i++) {
+            parser.add<ComplexFlag>(tokens[i * 2], Policy::OPTIONAL, "A flag.")
+                .add<Arg<int>>("value", Policy::MANDATORY, "An integer.");
+        }
+        TemporaryFile file("validate", tokens);
+        string responseToken = "@" + file.path;
+        vector<const char*> argv = {"benchmark"};
+        for (const auto& token : tokens) {
+            argv.push_back(token.c_str());
+        }
+        vector<const char*> responseArgv = {"benchmark",
+                                            responseToken.c_str()};
+        ParseResults results;
+        suite.measure("responsefile/argv", {{"tokens", tokens.size()}},
+                      tokens.size(), [&]() {
+                          parser.parseArgs((int)argv.size(), argv.data(),
+                                           results);
+                          sink = results.numberTokensParsed;
+                      });
+        suite.measure("responsefile/parse", {{"tokens", tokens.size()}},
+                      tokens.size(), [&]() {
+                          parser.parseArgs((int)responseArgv.size(),
+                                           responseArgv.data(), results);
+                          sink = results.numberTokensParsed;
+                      });
+    }
+}
+}  // namespace
+
+void runResponseFileBenchmarks(Suite& suite) {
+    benchmarkTokenizer(suite);
+    benchmarkValidation(suite);
+}
+}  // namespace Benchmarks
@@ -0,0 +1,66 @@
+// The compile time StaticSchema against an ArgParser describing the same
+// command line.
+#include <memory>
+#include <string>
+#include <vector>
+#include "autoArgParse/staticSchema.h"
+#include "benchmark.h"
+using namespace std;
+using namespace AutoArgParse;
+
+namespace Benchmarks {
+namespace {
+#define BENCHMARK_OPTION(i) \
+    staticOption<int>("--option" #i, Policy::OPTIONAL, "An integer.")
+constexpr auto staticCli = makeStaticSchema(
+    staticFlag("--verbose", Policy::OPTIONAL, "Print progress."),
+    BENCHMARK_OPTION(0), BENCHMARK_OPTION(1), BENCHMARK_OPTION(2),
+    BENCHMARK_OPTION(3), BENCHMARK_OPTION(4), BENCHMARK_OPTION(5),
+    BENCHMARK_OPTION(6), BENCHMARK_OPTION(7), BENCHMARK_OPTION(8),
+    BENCHMARK_OPTION(9), BENCHMARK_OPTION(10), BENCHMARK_OPTION(11),
+    BENCHMARK_OPTION(12), BENCHMARK_OPTION(13), BENCHMARK_OPTION(14),
+    BENCHMARK_OPTION(15),
+    staticArg<StringView>("input", Policy::MANDATORY, "Input file."));
+#undef BENCHMARK_OPTION
+const size_t NUMBER_OPTIONS = 16;
+
+unique_ptr<ArgParser> makeRuntimeCli() {
+    unique_ptr<ArgParser> parser(new ArgParser());
+    parser->add<Flag>("--verbose", Policy::OPTIONAL, "Print progress.");
+    for (size_t i = 0; i < NUMBER_OPTIONS; i++) {
+        parser
+            ->add<ComplexFlag>("--option" + to_string(i), Policy::OPTIONAL,
+                               "An integer.")
+            .add<Arg<int>>("value", Policy::MANDATORY, "An integer.");
+    }
+    parser->add<Arg<StringView>>("input", Policy::MANDATORY, "Input file.");
+    return parser;
+}
+}  // namespace
+
+void runStaticSchemaBenchmarks(Suite& suite) {
+    vector<string> strings = {"benchmark", "--verbose"};
+    for (size_t i = 0; i < NUMBER_OPTIONS; i++) {
+        strings.push_back("--option" + to_string(i));
+        strings.push_back(to_string(i));
+    }
+    strings.push_back("input.txt");
+    vector<const char*> argv;
+    for (const auto& token : strings) {
+        argv.push_back(token.c_str());
+    }
+    const int argc = (int)argv.size();
+    suite.measure("static/parse", {{"tokens", argc - 1}}, argc - 1, [&]() {
+        auto result = staticCli.parse(argc, argv.data());
+        sink = result.get<staticCli.indexOf("--option3")>();
+    });
+    suite.measure("static/parse/runtime", {{"tokens", argc - 1}}, argc - 1,
+                  makeRuntimeCli, [&](unique_ptr<ArgParser>& parser) {
+                      parser->validateArgs(argc, argv.data(), false);
+                      sink = parser->getNumberArgsSuccessfullyParsed();
+                  });
+    suite.measure("static/construct/runtime", {{"flags", NUMBER_OPTIONS + 1}},
+                  NUMBER_OPTIONS + 1,
+                  [&]() { sink = makeRuntimeCli()->getArgs().size(); });
+}
+}  // namespace Benchmarks
@@ -0,0 +1,258 @@
+#ifndef AUTOARGPARSE_ARENA_H_
+#define AUTOARGPARSE_ARENA_H_
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include "exceptions.h"
+#include "stringView.h"
+namespace AutoArgParse {
+
+/**
+ * Bump allocator holding the nodes, strings and containers of a schema.
+ * Memory is handed out from a short list of large blocks and is only released
+ * when the arena is destroyed, in one go.  Objects placed in the arena must
+ * still be destroyed by their owner (see NodeDeleter), the arena only owns
+ * the memory.  Buffers that containers give back when they grow are kept on a
+ * free list per size and handed out again, large ones go back to the heap,
+ * see allocateBuffer().
+ */
+class Arena {
+    struct Block {
+        Block* next;
+        size_t size;
+    };
+    static const size_t MAX_BLOCK_SIZE = 1 << 20;
+    struct FreeBuffer {
+        FreeBuffer* next;
+    };
+    // a buffer of LARGE_BUFFER_SIZE bytes or more, taken from the heap
+    struct alignas(std::max_align_t) LargeBuffer {
+        LargeBuffer* prev;
+        LargeBuffer* next;
+        size_t size;
+    };
+    static const size_t LARGE_BUFFER_SIZE = MAX_BLOCK_SIZE / 16;
+    Block* head = NULL;
+    LargeBuffer* largeBuffers = NULL;
+    char* cursor = NULL;
+    char* limit = NULL;
+    // buffers given back, by size
+    std::unordered_map<size_t, FreeBuffer*> freeBuffers;
+    size_t nextBlockSize;
+    size_t _numberBlocks = 0;
+    size_t _bytesReserved = 0;
+    size_t _bytesUsed = 0;
+
+    inline void addBlock(size_t minSize) {
+        size_t size = std::max(nextBlockSize, minSize + sizeof(Block));
+        Block* block = static_cast<Block*>(malloc(size));
+        if (!block) {
+            AUTOARGPARSE_THROW(std::bad_alloc());
+        }
+        block->next = head;
+        block->size = size;
+        head = block;
+        cursor = reinterpret_cast<char*>(block + 1);
+        limit = reinterpret_cast<char*>(block) + size;
+        nextBlockSize = std::min(nextBlockSize * 2, size_t(MAX_BLOCK_SIZE));
+        ++_numberBlocks;
+        _bytesReserved += size;
+    }
+
+   public:
+    explicit Arena(size_t initialBlockSize = 4096)
+        : nextBlockSize(initialBlockSize) {}
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    ~Arena() {
+        while (head) {
+            Block* next = head->next;
+            free(head);
+            head = next;
+        }
+        while (largeBuffers) {
+            LargeBuffer* next = largeBuffers->next;
+            free(largeBuffers);
+            largeBuffers = next;
+        }
+    }
+
+    inline void* allocate(size_t size, size_t alignment) {
+        size_t padding = (alignment - reinterpret_cast<size_t>(cursor) %
+                                          alignment) %
+                         alignment;
+        if (!head || size + padding > static_cast<size_t>(limit - cursor)) {
+            addBlock(size + alignment);
+            padding = (alignment -
+                       reinterpret_cast<size_t>(cursor) % alignment) %
+                      alignment;
+        }
+        char* result = cursor + padding;
+        cursor = result + size;
+        _bytesUsed += size + padding;
+        return result;
+    }
+
+    /** Construct a T inside the arena. */
+    template <typename T, typename... Args>
+    inline T* create(Args&&... args) {
+        return new (allocate(sizeof(T), alignof(T)))
+            T(std::forward<Args>(args)...);
+    }
+
+    /** Copy the characters of `str` into the arena, null terminated. */
+    inline StringView copy(StringView str) {
+        char* data = static_cast<char*>(allocate(str.size() + 1, 1));
+        memcpy(data, str.data(), str.size());
+        data[str.size()] = '\0';
+        return StringView(data, str.size());
+    }
+
+    /**
+     * Memory for a container buffer of `size` bytes, a buffer of that size
+     * given back through freeBuffer() if there is one.  Buffers are aligned
+     * by their size, up to max_align_t, so any type whose arrays take `size`
+     * bytes may reuse them.  Buffers of LARGE_BUFFER_SIZE or more, whose
+     * sizes rarely come up twice, are taken from the heap instead.
+     */
+    inline void* allocateBuffer(size_t size) {
+        if (size >= LARGE_BUFFER_SIZE) {
+            LargeBuffer* buffer = static_cast<LargeBuffer*>(
+                malloc(sizeof(LargeBuffer) + size));
+            if (!buffer) {
+                AUTOARGPARSE_THROW(std::bad_alloc());
+            }
+            buffer->prev = NULL;
+            buffer->next = largeBuffers;
+            buffer->size = size;
+            if (largeBuffers) {
+                largeBuffers->prev = buffer;
+            }
+            largeBuffers = buffer;
+            _bytesReserved += sizeof(LargeBuffer) + size;
+            _bytesUsed += size;
+            return buffer + 1;
+        }
+        if (!freeBuffers.empty()) {
+            auto found = freeBuffers.find(size);
+            if (found != freeBuffers.end() && found->second) {
+                FreeBuffer* buffer = found->second;
+                found->second = buffer->next;
+                _bytesUsed += size;
+                return buffer;
+            }
+        }
+        // the lowest set bit of the size, 1 for an empty buffer
+        size_t alignment = std::max<size_t>(size & (0 - size), 1);
+        return allocate(size,
+                        std::min(alignment, alignof(std::max_align_t)));
+    }
+
+    /** Give back a buffer of `size` bytes from allocateBuffer(). */
+    inline void freeBuffer(void* data, size_t size) {
+        if (size >= LARGE_BUFFER_SIZE) {
+            LargeBuffer* buffer = static_cast<LargeBuffer*>(data) - 1;
+            (buffer->prev ? buffer->prev->next : largeBuffers) = buffer->next;
+            if (buffer->next) {
+                buffer->next->prev = buffer->prev;
+            }
+            _bytesReserved -= sizeof(LargeBuffer) + size;
+            _bytesUsed -= size;
+            free(buffer);
+            return;
+        }
+        if (size < sizeof(FreeBuffer)) {
+            return;
+        }
+        FreeBuffer* buffer = static_cast<FreeBuffer*>(data);
+        FreeBuffer*& list = freeBuffers[size];
+        buffer->next = list;
+        list = buffer;
+        _bytesUsed -= size;
+    }
+
+    inline size_t numberBlocks() const { return _numberBlocks; }
+    /** bytes obtained from malloc */
+    inline size_t bytesReserved() const { return _bytesReserved; }
+    /** bytes handed out and not given back, including alignment padding */
+    inline size_t bytesUsed() const { return _bytesUsed; }
+};
+
+/**
+ * Standard allocator drawing container buffers from an Arena, buffers
+ * deallocated go back to the arena for reuse.  Without an arena it falls back
+ * to the global heap so that containers can be created before the arena they
+ * will live in is known.
+ */
+template <typename T>
+class ArenaAllocator {
+    template <typename U>
+    friend class ArenaAllocator;
+    Arena* arena;
+
+   public:
+    typedef T value_type;
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    ArenaAllocator(Arena* arena = NULL) : arena(arena) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    inline T* allocate(size_t n) {
+        if (arena) {
+            static_assert(alignof(T) <= alignof(std::max_align_t),
+                          "arena buffers are aligned for max_align_t");
+            return static_cast<T*>(arena->allocateBuffer(n * sizeof(T)));
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    inline void deallocate(T* p, size_t n) {
+        if (arena) {
+            arena->freeBuffer(p, n * sizeof(T));
+        } else {
+            ::operator delete(p);
+        }
+    }
+
+    template <typename U>
+    struct rebind {
+        typedef ArenaAllocator<U> other;
+    };
+
+    template <typename U>
+    inline bool operator==(const ArenaAllocator<U>& other) const {
+        return arena == other.arena;
+    }
+    template <typename U>
+    inline bool operator!=(const ArenaAllocator<U>& other) const {
+        return arena != other.arena;
+    }
+};
+
+/**
+ * Deleter for nodes that may have been created in an Arena, in which case
+ * only the destructor is run.
+ */
+struct NodeDeleter {
+    bool inArena = false;
+    NodeDeleter() = default;
+    NodeDeleter(bool inArena) : inArena(inArena) {}
+    template <typename T>
+    inline void operator()(T* node) const {
+        if (inArena) {
+            node->~T();
+        } else {
+            delete node;
+        }
+    }
+};
+}  // namespace AutoArgParse
+#endif /* AUTOARGPARSE_ARENA_H_ */
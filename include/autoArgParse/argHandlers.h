@@ -3,17 +3,94 @@
 
 #ifndef AUTOARGPARSE_ARGHANDLERS_H_
 #define AUTOARGPARSE_ARGHANDLERS_H_
+#include <cctype>
+#include <cerrno>
+#include <clocale>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <limits>
 #include <sstream>
 #include <string>
 #include <tuple>
+#include <type_traits>
 #include <utility>
+#include "exceptions.h"
+#include "stringView.h"
+#if defined(__has_include)
+#if __has_include(<charconv>) && __cplusplus >= 201703L
+#include <charconv>
+#endif
+#endif
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+#define AUTOARGPARSE_FLOAT_FROM_CHARS 1
+#else
+#define AUTOARGPARSE_FLOAT_FROM_CHARS 0
+#endif
+
 namespace AutoArgParse {
 struct ErrorMessage : public std::exception {
     const std::string message;
     ErrorMessage(const std::string& message) : message(message) {}
+    virtual const char* what() const noexcept { return message.c_str(); }
 };
 
+/** Why a converter rejected a token, see ConversionResult. */
+class ConversionError {
+    // messages built once (e.g. function statics) are referred to, not copied
+    const std::string* staticMessage = NULL;
+    std::string ownedMessage;
+
+   public:
+    ConversionError() = default;
+    explicit ConversionError(std::string message)
+        : ownedMessage(std::move(message)) {}
+
+    /** Refer to a message that lives for the rest of the program. */
+    static inline ConversionError fromStatic(const std::string& message) {
+        ConversionError error;
+        error.staticMessage = &message;
+        return error;
+    }
+
+    inline const std::string& message() const {
+        return (staticMessage) ? *staticMessage : ownedMessage;
+    }
+};
+
+/**
+ * Either a converted value or the reason the token was rejected.  Converters
+ * may provide `ConversionResult<T> tryConvert(StringView) const` next to
+ * their call operator, tokens are then rejected without throwing, which
+ * matters when optional args are offered tokens that they do not accept.
+ * Converters that only throw ErrorMessage keep working, see tryConvert().
+ */
+template <typename T>
+class ConversionResult {
+    bool _succeeded;
+
+   public:
+    T value;
+    ConversionError error;
+
+    ConversionResult(T value) : _succeeded(true), value(std::move(value)) {}
+    ConversionResult(ConversionError error)
+        : _succeeded(false), value(), error(std::move(error)) {}
+
+    inline explicit operator bool() const { return _succeeded; }
+};
+
+namespace detail {
+/** The call operator of a converter providing tryConvert(). */
+template <typename T>
+inline T valueOrThrow(ConversionResult<T>&& result) {
+    if (!result) {
+        AUTOARGPARSE_THROW(ErrorMessage(result.error.message()));
+    }
+    return std::move(result.value);
+}
+}  // namespace detail
+
 /** a fake converter object, should never be called, used only to assist with
 meta programming. */
 template <typename T>
@@ -24,23 +101,110 @@ struct FakeDoNothingConverter {
     }
 };
 
+namespace detail {
+template <typename Func, typename Arg>
+struct HasTryConvert {
+    template <typename F>
+    static std::true_type test(
+        decltype(std::declval<F&>().tryConvert(std::declval<Arg>()))*);
+    template <typename F>
+    static std::false_type test(...);
+    static const bool value = decltype(test<Func>(NULL))::value;
+};
+
+template <typename Func, typename Arg>
+inline auto tryConvert(Func& func, Arg&& arg, std::true_type)
+    -> decltype(func.tryConvert(std::forward<Arg>(arg))) {
+    return func.tryConvert(std::forward<Arg>(arg));
+}
+
+template <typename Func, typename Arg>
+inline ConversionResult<typename std::decay<decltype(
+    std::declval<Func&>()(std::declval<Arg>()))>::type>
+tryConvert(Func& func, Arg&& arg, std::false_type) {
+#if AUTOARGPARSE_EXCEPTIONS
+    try {
+        return func(std::forward<Arg>(arg));
+    } catch (ErrorMessage& e) {
+        return ConversionError(e.message);
+    }
+#else
+    return func(std::forward<Arg>(arg));
+#endif
+}
+
+/** Whether a converter rejects tokens by throwing ErrorMessage: those without
+ * tryConvert() do, others only if they declare `static constexpr bool throws
+ * = true`, as ThrowingConverter does. */
+template <typename Func, typename Arg, typename Enable = void>
+struct ConverterThrows
+    : std::integral_constant<bool, !HasTryConvert<Func, Arg>::value> {};
+
+template <typename Func, typename Arg>
+struct ConverterThrows<Func, Arg, decltype(void(Func::throws))>
+    : std::integral_constant<bool, Func::throws> {};
+}  // namespace detail
+
+/**
+ * Apply a converter (or constraint) without throwing on rejection.  Uses the
+ * converter's tryConvert() when it has one, otherwise calls it and catches
+ * the ErrorMessage it throws.
+ */
+template <typename Func, typename Arg>
+inline auto tryConvert(Func&& func, Arg&& arg) -> decltype(detail::tryConvert(
+    func, std::forward<Arg>(arg),
+    std::integral_constant<bool, detail::HasTryConvert<Func, Arg>::value>())) {
+    return detail::tryConvert(
+        func, std::forward<Arg>(arg),
+        std::integral_constant<bool,
+                               detail::HasTryConvert<Func, Arg>::value>());
+}
+
 /**
- * Default object for converting strings to types.  Defaults to using
- * `istringstream` and the `>>` operator. can be specialised to use custom
- * parser.
+ * Gives a converter that reports errors by throwing ErrorMessage the
+ * tryConvert() protocol, exceptions are then caught where it is called.
+ */
+template <typename Func>
+struct ThrowingConverter {
+    // its tryConvert() catches what func throws
+    static constexpr bool throws = true;
+    Func func;
+    ThrowingConverter(Func func) : func(std::move(func)) {}
+
+    template <typename Arg>
+    inline auto operator()(Arg&& arg)
+        -> decltype(func(std::forward<Arg>(arg))) {
+        return func(std::forward<Arg>(arg));
+    }
+    template <typename Arg>
+    inline auto tryConvert(Arg&& arg) -> decltype(detail::tryConvert(
+        func, std::forward<Arg>(arg), std::false_type())) {
+        return detail::tryConvert(func, std::forward<Arg>(arg),
+                                  std::false_type());
+    }
+};
+
+/**
+ * Converts strings to types using `istringstream` and the `>>` operator.  This
+ * is what `Converter` falls back to for types without a dedicated converter.
  */
 template <typename T>
-struct Converter {
-    inline T operator()(const std::string& stringArgToParse) const {
+struct StreamConverter {
+    inline ConversionResult<T> tryConvert(StringView stringArgToParse) const {
+        static const std::string message = makeErrorMessage();
         T value;
-        std::istringstream is(stringArgToParse);
+        std::istringstream is(stringArgToParse.str());
         bool success(is >> value);
         if (!success) {
-            throw ErrorMessage(makeErrorMessage());
+            return ConversionError::fromStatic(message);
         }
         return value;
     }
 
+    inline T operator()(StringView stringArgToParse) const {
+        return detail::valueOrThrow(tryConvert(stringArgToParse));
+    }
+
     // allow custom error messages for integral, float and unsigned types
     static inline std::string makeErrorMessage() {
         std::ostringstream os;
@@ -60,35 +224,315 @@ struct Converter {
     }
 };
 
+namespace detail {
+
+/** Integer types parsed as numbers, character types and bool are excluded as
+ * they read as characters/flags through streams.*/
+template <typename T>
+struct IsIntegerNumber
+    : std::integral_constant<
+          bool, std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+                    !std::is_same<T, char>::value &&
+                    !std::is_same<T, signed char>::value &&
+                    !std::is_same<T, unsigned char>::value &&
+                    !std::is_same<T, wchar_t>::value &&
+                    !std::is_same<T, char16_t>::value &&
+                    !std::is_same<T, char32_t>::value> {};
+
+enum NumberParseResult {
+    PARSED_NUMBER,
+    NOT_A_NUMBER,
+    NUMBER_TOO_LARGE,
+    NUMBER_TOO_SMALL
+};
+
+/**
+ * Parse a base 10 integer with an optional sign.  The whole token must be
+ * consumed. Does not allocate and does not depend on the locale.
+ */
+template <typename T>
+inline NumberParseResult parseInteger(StringView token, T& value) {
+    typedef typename std::make_unsigned<T>::type UnsignedT;
+    const char* pos = token.begin();
+    const char* end = token.end();
+    bool negative = false;
+    if (pos != end && (*pos == '-' || *pos == '+')) {
+        negative = *pos == '-';
+        ++pos;
+    }
+    if (pos == end) {
+        return NOT_A_NUMBER;
+    }
+    // largest magnitude allowed given the sign
+    const UnsignedT limit =
+        (!negative) ? UnsignedT(std::numeric_limits<T>::max())
+                    : (std::is_signed<T>::value)
+                          ? UnsignedT(UnsignedT(std::numeric_limits<T>::max()) +
+                                      1)
+                          : UnsignedT(0);
+    UnsignedT magnitude = 0;
+    bool outOfRange = false;
+    for (; pos != end; ++pos) {
+        unsigned digit = unsigned(static_cast<unsigned char>(*pos)) - '0';
+        if (digit > 9) {
+            return NOT_A_NUMBER;
+        }
+        // keep scanning when out of range so that garbage is still reported
+        // as such
+        if (digit > limit || magnitude > (limit - digit) / 10) {
+            outOfRange = true;
+        } else {
+            magnitude = UnsignedT(magnitude * 10 + digit);
+        }
+    }
+    if (outOfRange) {
+        return (negative) ? NUMBER_TOO_SMALL : NUMBER_TOO_LARGE;
+    }
+    if (negative && magnitude != 0) {
+        // magnitude - 1 always fits in T, avoids overflowing on the minimum
+        value = T(-T(magnitude - 1) - 1);
+    } else {
+        value = T(magnitude);
+    }
+    return PARSED_NUMBER;
+}
+
+inline float strToFloat(const char* str, char** end, float) {
+    return strtof(str, end);
+}
+inline double strToFloat(const char* str, char** end, double) {
+    return strtod(str, end);
+}
+inline long double strToFloat(const char* str, char** end, long double) {
+    return strtold(str, end);
+}
+
+/** Classify a token that strto* reports as out of range, only used on error
+ * paths.*/
+template <typename T>
+inline NumberParseResult classifyFloatRangeError(const char* str) {
+    T value = strToFloat(str, NULL, T());
+    return (value == std::numeric_limits<T>::infinity() ||
+            value == -std::numeric_limits<T>::infinity())
+               ? NUMBER_TOO_LARGE
+               : NUMBER_TOO_SMALL;
+}
+
+/**
+ * Parse a decimal floating point number, the whole token must be consumed.
+ * Uses `std::from_chars` when the standard library provides it for floating
+ * point types.  Otherwise falls back to `strto*` on a stack copy of the token
+ * in which '.' is swapped for the decimal point of the C locale, any other
+ * character than digits, signs, exponents and '.' being rejected, so the
+ * decimal point is always '.' whatever LC_NUMERIC is.  Both reject
+ * hexadecimal numbers, "inf" and "nan", so a command line parses the same
+ * whichever is used.
+ */
+template <typename T>
+inline NumberParseResult parseFloat(StringView token, T& value) {
+    const char* pos = token.begin();
+    const char* end = token.end();
+    const char* digits =
+        (pos != end && (*pos == '+' || *pos == '-')) ? pos + 1 : pos;
+    if (pos != end && *pos == '+') {
+        pos = digits;
+    }
+    // reject what strto* and from_chars would otherwise skip or accept: the
+    // digits or decimal point must follow at most one sign and must not
+    // start a hexadecimal number
+    if (digits == end ||
+        (!isdigit(static_cast<unsigned char>(*digits)) && *digits != '.') ||
+        (*digits == '0' && digits + 1 != end &&
+         (digits[1] == 'x' || digits[1] == 'X'))) {
+        return NOT_A_NUMBER;
+    }
+#if AUTOARGPARSE_FLOAT_FROM_CHARS
+    std::from_chars_result result = std::from_chars(pos, end, value);
+    if (result.ptr != end) {
+        return NOT_A_NUMBER;
+    }
+    if (result.ec == std::errc::result_out_of_range) {
+        return classifyFloatRangeError<T>(std::string(pos, end).c_str());
+    }
+    return (result.ec == std::errc()) ? PARSED_NUMBER : NOT_A_NUMBER;
+#else
+    const char* point = localeconv()->decimal_point;
+    const size_t pointLength = strlen(point);
+    // the copy holds at most one decimal point, a second is rejected
+    const size_t maxLength = size_t(end - pos) + pointLength;
+    char buffer[64];
+    std::string longToken;
+    char* str = buffer;
+    if (maxLength >= sizeof(buffer)) {
+        longToken.resize(maxLength + 1);
+        str = &longToken[0];
+    }
+    size_t length = 0;
+    bool seenPoint = false;
+    for (const char* c = pos; c != end; ++c) {
+        if (*c == '.' && !seenPoint) {
+            seenPoint = true;
+            memcpy(str + length, point, pointLength);
+            length += pointLength;
+        } else if (isdigit(static_cast<unsigned char>(*c)) || *c == '+' ||
+                   *c == '-' || *c == 'e' || *c == 'E') {
+            str[length++] = *c;
+        } else {
+            return NOT_A_NUMBER;
+        }
+    }
+    str[length] = '\0';
+    char* parseEnd;
+    errno = 0;
+    T parsed = strToFloat(str, &parseEnd, T());
+    if (parseEnd != str + length) {
+        return NOT_A_NUMBER;
+    }
+    if (errno == ERANGE) {
+        return classifyFloatRangeError<T>(str);
+    }
+    value = parsed;
+    return PARSED_NUMBER;
+#endif
+}
+
+/** Error messages for number conversions, built once per type.*/
+template <typename T>
+inline const std::string& numberErrorMessage(NumberParseResult result) {
+    static const std::string notANumber =
+        StreamConverter<T>::makeErrorMessage();
+    static const std::string tooLarge =
+        (std::is_integral<T>::value)
+            ? "Value too large, expected an integer no greater than " +
+                  std::to_string(std::numeric_limits<T>::max()) + "."
+            : std::string("Value too large to be represented as a number.");
+    static const std::string tooSmall =
+        (std::is_integral<T>::value)
+            ? "Value too small, expected an integer no less than " +
+                  std::to_string(std::numeric_limits<T>::min()) + "."
+            : std::string("Value too close to zero to be represented as a "
+                          "number.");
+    return (result == NUMBER_TOO_LARGE)
+               ? tooLarge
+               : (result == NUMBER_TOO_SMALL) ? tooSmall : notANumber;
+}
+}  // namespace detail
+
+namespace detail {
+/** The converter Converter<T> derives from unless specialised, picked by the
+ * kind of T. */
+template <typename T, typename Enable = void>
+struct DefaultConverter : public StreamConverter<T> {};
+
+/**
+ * Integer conversion, the whole argument must be a base 10 integer within the
+ * range of T.  Does not allocate unless the conversion fails.
+ */
+template <typename T>
+struct DefaultConverter<
+    T, typename std::enable_if<IsIntegerNumber<T>::value>::type> {
+    inline ConversionResult<T> tryConvert(StringView stringArgToParse) const {
+        T value;
+        NumberParseResult result = parseInteger(stringArgToParse, value);
+        if (result != PARSED_NUMBER) {
+            return ConversionError::fromStatic(numberErrorMessage<T>(result));
+        }
+        return value;
+    }
+
+    inline T operator()(StringView stringArgToParse) const {
+        return valueOrThrow(tryConvert(stringArgToParse));
+    }
+};
+
+/**
+ * Floating point conversion, the whole argument must be a decimal number
+ * within the range of T.  Does not allocate unless the conversion fails.
+ */
+template <typename T>
+struct DefaultConverter<
+    T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+    inline ConversionResult<T> tryConvert(StringView stringArgToParse) const {
+        T value;
+        NumberParseResult result = parseFloat(stringArgToParse, value);
+        if (result != PARSED_NUMBER) {
+            return ConversionError::fromStatic(numberErrorMessage<T>(result));
+        }
+        return value;
+    }
+
+    inline T operator()(StringView stringArgToParse) const {
+        return valueOrThrow(tryConvert(stringArgToParse));
+    }
+};
+}  // namespace detail
+
+/**
+ * Default object for converting strings to types.  Integer and floating point
+ * types use the allocation free converters above, others default to using
+ * `istringstream` and the `>>` operator (see StreamConverter). can be
+ * specialised to use custom parser.  Converters receive the token as a
+ * StringView into the command line, only those that need to own the
+ * characters should copy them.
+ */
+template <typename T>
+struct Converter : public detail::DefaultConverter<T> {};
+
 template <>
 struct Converter<std::string> {
-    inline std::string operator()(const std::string& stringArgToParse) const {
+    inline ConversionResult<std::string> tryConvert(
+        StringView stringArgToParse) const {
+        return stringArgToParse.str();
+    }
+    inline std::string operator()(StringView stringArgToParse) const {
+        return stringArgToParse.str();
+    }
+};
+
+/** Keeps the argument as a view of the command line, never copies it. */
+template <>
+struct Converter<StringView> {
+    inline ConversionResult<StringView> tryConvert(
+        StringView stringArgToParse) const {
+        return stringArgToParse;
+    }
+    inline StringView operator()(StringView stringArgToParse) const {
         return stringArgToParse;
     }
 };
 
 template <>
 struct Converter<std::ifstream> {
-    inline std::ifstream operator()(const std::string& stringArgToParse) const {
-        std::ifstream inFile(stringArgToParse);
+    inline ConversionResult<std::ifstream> tryConvert(
+        StringView stringArgToParse) const {
+        const std::string path = stringArgToParse.str();
+        std::ifstream inFile(path);
         if (!inFile.good()) {
-            throw ErrorMessage("Could not open file " + stringArgToParse +
-                               " for reading.");
+            return ConversionError("Could not open file " + path +
+                                   " for reading.");
         }
         return inFile;
     }
+    inline std::ifstream operator()(StringView stringArgToParse) const {
+        return detail::valueOrThrow(tryConvert(stringArgToParse));
+    }
 };
 
 template <>
 struct Converter<std::ofstream> {
-    inline std::ofstream operator()(const std::string& stringArgToParse) const {
-        std::ofstream outFile(stringArgToParse);
+    inline ConversionResult<std::ofstream> tryConvert(
+        StringView stringArgToParse) const {
+        const std::string path = stringArgToParse.str();
+        std::ofstream outFile(path);
         if (!outFile.good()) {
-            throw ErrorMessage("Could not open file " + stringArgToParse +
-                               " for writing.");
+            return ConversionError("Could not open file " + path +
+                                   " for writing.");
         }
         return outFile;
     }
+    inline std::ofstream operator()(StringView stringArgToParse) const {
+        return detail::valueOrThrow(tryConvert(stringArgToParse));
+    }
 };
 
 /*helper classes for the chain function, a function that composes multiple
@@ -110,6 +554,18 @@ class Composed {
         -> decltype(func2(func1(std::forward<T>(arg)))) {
         return func2(func1(std::forward<T>(arg)));
     }
+
+    /** Stops at the first function rejecting its input, without throwing
+     * unless one of the functions only reports errors by throwing.*/
+    template <typename T>
+    inline auto tryConvert(T&& arg) -> decltype(AutoArgParse::tryConvert(
+        func2, AutoArgParse::tryConvert(func1, std::forward<T>(arg)).value)) {
+        auto first = AutoArgParse::tryConvert(func1, std::forward<T>(arg));
+        if (!first) {
+            return std::move(first.error);
+        }
+        return AutoArgParse::tryConvert(func2, std::move(first.value));
+    }
 };
 template <typename Func1, typename Func2>
 inline Composed<Func1, Func2> composed(Func1&& func1, Func2&& func2) {
@@ -143,6 +599,87 @@ inline typename detail::ChainType<Func, Funcs...>::type chain(
                             chain(std::forward<Funcs>(funcs)...));
 }
 
+/**
+ * A converter whose tokens are checked by `validator` while parsing, before
+ * and apart from the conversion itself.  This is what lets LazyArg reject a
+ * malformed command line up front yet only convert on first use.  The
+ * validator may be any converter or constraint taking the token, what it
+ * returns is ignored.  Use validated() to make one.
+ */
+template <typename Validator, typename ConverterFunc>
+struct ValidatingConverter {
+    Validator validator;
+    ConverterFunc convert;
+
+    ValidatingConverter(Validator validator, ConverterFunc convert)
+        : validator(std::move(validator)), convert(std::move(convert)) {}
+
+    template <typename Arg>
+    inline auto operator()(Arg&& arg)
+        -> decltype(convert(std::forward<Arg>(arg))) {
+        return convert(std::forward<Arg>(arg));
+    }
+    template <typename Arg>
+    inline auto tryConvert(Arg&& arg)
+        -> decltype(AutoArgParse::tryConvert(convert,
+                                             std::forward<Arg>(arg))) {
+        return AutoArgParse::tryConvert(convert, std::forward<Arg>(arg));
+    }
+
+    inline bool validate(StringView token, ConversionError& error) {
+        auto checked = AutoArgParse::tryConvert(validator, token);
+        if (!checked) {
+            error = std::move(checked.error);
+            return false;
+        }
+        return true;
+    }
+};
+
+template <typename Validator, typename ConverterFunc>
+inline ValidatingConverter<typename std::decay<Validator>::type,
+                           typename std::decay<ConverterFunc>::type>
+validated(Validator&& validator, ConverterFunc&& convert) {
+    return ValidatingConverter<typename std::decay<Validator>::type,
+                               typename std::decay<ConverterFunc>::type>(
+        std::forward<Validator>(validator),
+        std::forward<ConverterFunc>(convert));
+}
+
+namespace detail {
+template <typename Func>
+struct HasValidate {
+    template <typename F>
+    static std::true_type test(decltype(std::declval<F&>().validate(
+        std::declval<StringView>(), std::declval<ConversionError&>()))*);
+    template <typename F>
+    static std::false_type test(...);
+    static const bool value = decltype(test<Func>(NULL))::value;
+};
+
+template <typename Func>
+inline bool validateToken(Func& func, StringView token, ConversionError& error,
+                          std::true_type) {
+    return func.validate(token, error);
+}
+
+template <typename Func>
+inline bool validateToken(Func&, StringView, ConversionError&,
+                          std::false_type) {
+    return true;
+}
+
+/** Run the validator of a converter made by validated(), other converters
+ * accept every token here.*/
+template <typename Func>
+inline bool validateToken(Func& func, StringView token,
+                          ConversionError& error) {
+    return validateToken(
+        func, token, error,
+        std::integral_constant<bool, HasValidate<Func>::value>());
+}
+}  // namespace detail
+
 /**
  * Integer range constraint
  */
@@ -155,11 +692,11 @@ class IntRange {
           max(max),
           minInclusive(minInclusive),
           maxInclusive(maxInclusive) {}
-    int operator()(int parsedValue) const {
+    ConversionResult<int> tryConvert(int parsedValue) const {
         int testMin = (minInclusive) ? min : min + 1;
         int testMax = (maxInclusive) ? max : max - 1;
         if (parsedValue < testMin || parsedValue > testMax) {
-            throw ErrorMessage(
+            return ConversionError(
                 "Expected value to be between " + std::to_string(min) +
                 ((minInclusive) ? "(inclusive)" : "(exclusive") + " and " +
                 std::to_string(max) +
@@ -167,6 +704,9 @@ class IntRange {
         }
         return parsedValue;
     }
+    int operator()(int parsedValue) const {
+        return detail::valueOrThrow(tryConvert(parsedValue));
+    }
 };
 }  // namespace AutoArgParse
 
@@ -2,7 +2,10 @@
 #define AUTOARGPARSE_ARGPARSER_CPP_
 
 #include "argParser.h"
+#include <cstring>
+#include <sstream>
 #include <stdexcept>
+#include <type_traits>
 #include "parseException.h"
 
 #if AUTOARGPARSE_HEADER_ONLY
@@ -12,47 +15,191 @@
 #endif
 
 namespace AutoArgParse {
-AUTOARGPARSE_INLINE void FlagStore::parse(ArgIter& first, ArgIter& last) {
-    int numberParsedMandatoryFlags = 0;
-    int numberParsedMandatoryArgs = 0;
-    while (first != last) {
-        Policy foundPolicy;
-        if (tryParseFlag(first, last, foundPolicy)) {
-            if (foundPolicy == Policy::MANDATORY) {
-                numberParsedMandatoryFlags++;
+namespace detail {
+/** The name `-c` of a short flag, a view of a static table so that clusters of
+ * short flags are split without allocating. */
+AUTOARGPARSE_INLINE StringView shortFlagName(unsigned char c) {
+    static const struct ShortNames {
+        char names[256][2];
+        ShortNames() {
+            for (int i = 0; i < 256; i++) {
+                names[i][0] = '-';
+                names[i][1] = static_cast<char>(i);
             }
-        } else if (tryParseArg(first, last, foundPolicy)) {
-            if (foundPolicy == Policy::MANDATORY) {
-                numberParsedMandatoryArgs++;
-            }
-        } else {
-            break;
         }
+    } table;
+    return StringView(table.names[c], 2);
+}
+}  // namespace detail
+
+AUTOARGPARSE_INLINE detail::ParseFrame FlagStore::beginParse(
+    ParseResults& results, const FlagBase* flag, StringView flagToken) const {
+    detail::ParseFrame frame;
+    frame.store = this;
+    frame.flag = flag;
+    frame.flagToken = flagToken;
+    frame.parsedFlags = results.flagBits.size();
+    frame.numberParsedMandatoryArgs = 0;
+#if AUTOARGPARSE_STATS
+    frame.start = std::chrono::steady_clock::now();
+#endif
+    results.flagBits.resize(
+        frame.parsedFlags + FlagSet::numberWords(flagSlots.size()), 0);
+    *static_cast<size_t*>(results.value(cursorOffset)) = 0;
+    return frame;
+}
+
+AUTOARGPARSE_INLINE bool FlagStore::checkMandatory(
+    ParseResults& results, size_t parsedFlags, int numberParsedMandatoryArgs,
+    ArgIter first, ArgIter last) const {
+    if (mandatoryFlags.firstNotIn(results.flagBits.data() + parsedFlags) !=
+        FlagSet::npos) {
+        results.fail((first == last) ? MISSING_MANDATORY_FLAG : UNEXPECTED_ARG,
+                     first)
+            .store = this;
+        return false;
     }
-    if (numberParsedMandatoryFlags != _numberMandatoryFlags) {
-        if (first == last) {
-            throw MissingMandatoryFlagException(*this);
-        } else {
-            throw UnexpectedArgException(*first, *this);
+    if (numberParsedMandatoryArgs != _numberMandatoryArgs) {
+        results.fail((first == last) ? MISSING_MANDATORY_ARG : UNEXPECTED_ARG,
+                     first)
+            .store = this;
+        return false;
+    }
+    return true;
+}
+
+AUTOARGPARSE_INLINE void FlagStore::endParse(ParseResults& results,
+                                            const detail::ParseFrame& frame) {
+#if AUTOARGPARSE_STATS
+    if (frame.flag) {
+        results.addNodeTime(*frame.flag, frame.flag->name, true,
+                            detail::nanosecondsSince(frame.start));
+    }
+#endif
+    results.flagBits.resize(frame.parsedFlags);
+}
+
+/**
+ * The innermost store being parsed is kept in `frame`, the `depth` stores
+ * holding it at the start of `results.frames`.  Only the parser's own store is
+ * parsed through here, so the frames may start from the first.  A flag token
+ * of the innermost store naming a flag with a nested store saves the frame and
+ * starts one for that store, which then takes the tokens.  A token the
+ * innermost store cannot take ends it: its mandatory flags and args are
+ * checked, the trigger of the flag holding it fired and the frame below
+ * restored, to be offered the token.  Each token thus costs one lookup in the
+ * flag table of the innermost store (see findFlag()), whatever the depth.
+ */
+AUTOARGPARSE_INLINE bool FlagStore::parse(ParseResults& results,
+                                          ArgIter& first,
+                                          ArgIter& last) const {
+    std::vector<detail::ParseFrame>& frames = results.frames;
+    detail::ParseFrame* stack = frames.data();
+    size_t depth = 0;
+    detail::ParseFrame frame = beginParse(results, NULL, StringView());
+    while (true) {
+        const FlagStore& store = *frame.store;
+        size_t& cursor =
+            *static_cast<size_t*>(results.value(store.cursorOffset));
+        const FlagBase* nested = NULL;
+        while (!results.stopped() && first != last) {
+            AUTOARGPARSE_COUNT(results, tokensExamined, 1);
+            Policy foundPolicy = Policy::OPTIONAL;
+            if (store.tryParseFlag(results, frame.parsedFlags, first, last,
+                                   nested)) {
+                if (nested) {
+                    break;
+                }
+            } else if (store.tryParseArg(results, cursor, first, last,
+                                         foundPolicy)) {
+                if (foundPolicy == Policy::MANDATORY) {
+                    frame.numberParsedMandatoryArgs++;
+                }
+            } else {
+                break;
+            }
+        }
+        if (nested) {
+            if (depth == frames.size()) {
+                frames.resize(depth + 8);
+                stack = frames.data();
+            }
+            stack[depth++] = frame;
+            frame = nested->getNestedStore()->beginParse(results, nested,
+                                                         first[-1]);
+            continue;
+        }
+        if (results.stopped() ||
+            !store.checkMandatory(results, frame.parsedFlags,
+                                  frame.numberParsedMandatoryArgs, first,
+                                  last)) {
+            endParse(results, frame);
+            while (depth > 0) {
+                endParse(results, stack[--depth]);
+            }
+            return false;
+        }
+        endParse(results, frame);
+        if (depth == 0) {
+            return true;
         }
+        const FlagBase& flag = *frame.flag;
+        const StringView flagToken = frame.flagToken;
+        frame = stack[--depth];
+        flag.nestedParsed(flagToken);
+        frame.store->flagParsed(results, flag, first, last);
     }
-    if (numberParsedMandatoryArgs != _numberMandatoryArgs) {
-        if (first == last) {
-            throw MissingMandatoryArgException(*this);
-        } else {
-            throw UnexpectedArgException(*first, *this);
+}
+
+AUTOARGPARSE_INLINE ArgIter FlagStore::endOfValues(ParseResults& results,
+                                                   size_t index,
+                                                   ArgIter first,
+                                                   ArgIter last) const {
+    ArgIter end = results.nextFlagToken(first, last);
+    while (end != last && !findFlag(results, end)) {
+        end = results.nextFlagToken(end + 1, last);
+    }
+    // leave a value for each mandatory arg still to come
+    int reserved = 0;
+    for (size_t i = index + 1; i < args.size(); i++) {
+        if (args[i]->policy == Policy::MANDATORY &&
+            !args[i]->parsed(results)) {
+            ++reserved;
         }
     }
+    return (std::distance(first, end) > reserved + 1) ? end - reserved
+                                                      : first + 1;
 }
 
-AUTOARGPARSE_INLINE bool FlagStore::tryParseArg(ArgIter& first, ArgIter& last,
-                                                Policy& foundArgPolicy) {
-    for (auto& argPtr : args) {
-        if (argPtr->parsed()) {
+/**
+ * Args take tokens in the order they were added.  `cursor` is the first arg
+ * not parsed yet, so the search for a taker is usually over after one step.
+ * Optional args that could not convert a token are skipped and may still
+ * take a later one.
+ */
+AUTOARGPARSE_INLINE bool FlagStore::tryParseArg(ParseResults& results,
+                                                size_t& cursor, ArgIter& first,
+                                                ArgIter& last,
+                                                Policy& foundArgPolicy) const {
+    while (cursor < args.size() && args[cursor]->parsed(results)) {
+        ++cursor;
+    }
+    for (size_t i = cursor; i < args.size(); i++) {
+        auto& argPtr = args[i];
+        if (argPtr->parsed(results)) {
             continue;
         }
-        argPtr->parse(first, last);
-        if (argPtr->parsed()) {
+        bool carryOn;
+        if (argPtr->collectsValues()) {
+            ArgIter endOfList = endOfValues(results, i, first, last);
+            carryOn = argPtr->parse(results, first, endOfList);
+        } else {
+            carryOn = argPtr->parse(results, first, last);
+        }
+        if (!carryOn) {
+            return true;
+        }
+        if (argPtr->parsed(results)) {
             foundArgPolicy = argPtr->policy;
             return true;
         }
@@ -60,23 +207,61 @@ AUTOARGPARSE_INLINE bool FlagStore::tryParseArg(ArgIter& first, ArgIter& last,
     return false;
 }
 
-AUTOARGPARSE_INLINE bool FlagStore::tryParseFlag(ArgIter& first, ArgIter& last,
-                                                 Policy& foundFlagPolicy) {
-    auto flagIter = flags.find(*first);
-    if (flagIter != end(flags)) {
-        if (flagIter->second->parsed()) {
-            throw RepeatedFlagException(*first);
-        }
-        ++first;
-        flagIter->second->parse(first, last);
-        foundFlagPolicy = flagIter->second->policy;
-        return true;
-    } else {
+AUTOARGPARSE_INLINE bool FlagStore::tryParseFlag(
+    ParseResults& results, size_t parsedFlags, ArgIter& first, ArgIter& last,
+    const FlagBase*& nested) const {
+    if (results.tokenKind(first) != FLAG_TOKEN) {
         return false;
     }
+    const FlagBase* found = findFlag(results, first);
+    if (!found) {
+        return false;
+    }
+    const FlagBase& flag = *found;
+    uint64_t* bits = results.flagBits.data() + parsedFlags;
+    if (FlagSet::contains(bits, flag.slot)) {
+        results.fail(REPEATED_FLAG, first);
+        return true;
+    }
+    const ExclusiveGroupBase* group = flag.exclusiveGroup;
+    if (group) {
+        size_t conflict = group->getMemberSlots().firstIn(bits);
+        if (conflict != FlagSet::npos) {
+            ParseFailure& failure =
+                results.fail(MORE_THAN_ONE_EXCLUSIVE_ARG, first);
+            failure.name = flagSlots[conflict]->name;
+            failure.exclusiveFlags = &group->getFlagNames();
+            // the conflicting flag counts as parsed, as it always has
+            ++first;
+            return true;
+        }
+        FlagSet::insert(bits, group->slot);
+        group->memberParsed(results, first);
+    }
+    FlagSet::insert(bits, flag.slot);
+    ++first;
+    results.markParsed(flag);
+    if (flag.getNestedStore()) {
+        nested = &flag;
+    } else if (flag.parse(results, first, last)) {
+        flagParsed(results, flag, first, last);
+    }
+    return true;
 }
 
-typedef std::pair<const std::string, FlagPtr> FlagMapping;
+AUTOARGPARSE_INLINE void FlagStore::flagParsed(ParseResults& results,
+                                               const FlagBase& flag,
+                                               ArgIter first,
+                                               ArgIter last) const {
+    if (flag.requestsHelp) {
+        results.helpRequested = true;
+    }
+    if (!results.stopped() && first != last &&
+        results.tokenKind(first) == ATTACHED_VALUE_TOKEN) {
+        // `--flag=value` where the flag took no value
+        results.fail(UNEXPECTED_ARG, first).store = this;
+    }
+}
 
 AUTOARGPARSE_INLINE void FlagStore::printUsageSummary(std::ostream& os) const {
     for (auto& argPtr : args) {
@@ -85,19 +270,21 @@ AUTOARGPARSE_INLINE void FlagStore::printUsageSummary(std::ostream& os) const {
             os << "[";
         }
         os << argPtr->name;
+        if (argPtr->collectsValues()) {
+            os << "...";
+        }
         if (argPtr->policy == Policy::OPTIONAL) {
             os << "]";
         }
     }
-    for (const auto& flag : flagInsertionOrder) {
-        auto& flagObj = flags.at(flag);
+    for (const FlagBase* flagObj : flagInsertionOrder) {
         os << " ";
 
         if (flagObj->policy == Policy::OPTIONAL) {
             os << "[";
         }
         if (!flagObj->isExclusiveGroup()) {
-            os << flag;
+            os << flagObj->name;
         }
         flagObj->printUsageSummary(os);
         if (flagObj->policy == Policy::OPTIONAL) {
@@ -106,14 +293,13 @@ AUTOARGPARSE_INLINE void FlagStore::printUsageSummary(std::ostream& os) const {
     }
 }
 
-AUTOARGPARSE_INLINE void printUsageHelp(
-    const std::deque<std::string>& flagInsertionOrder, const FlagMap& flags,
-    std::ostream& os, IndentedLine& lineIndent) {
-    for (const auto& flag : flagInsertionOrder) {
-        auto& flagObj = flags.at(flag);
+AUTOARGPARSE_INLINE void printUsageHelp(const FlagList& flagInsertionOrder,
+                                        std::ostream& os,
+                                        IndentedLine& lineIndent) {
+    for (const FlagBase* flagObj : flagInsertionOrder) {
         if (flagObj->description.size() > 0) {
             os << lineIndent;
-            os << flag;
+            os << flagObj->name;
             flagObj->printUsageSummary(os);
             os << lineIndent;
             if (flagObj->policy == Policy::OPTIONAL) {
@@ -134,17 +320,31 @@ AUTOARGPARSE_INLINE void FlagStore::printUsageHelp(
         if (argPtr->description.size() > 0) {
             os << lineIndent;
             os << argPtr->name;
+            if (argPtr->collectsValues()) {
+                os << "...";
+            }
             if (argPtr->policy == Policy::OPTIONAL) {
                 os << " [optional]";
             }
-            std::cout << ": " << argPtr->description;
+            os << ": " << argPtr->description;
         }
     }
-    AutoArgParse::printUsageHelp(flagInsertionOrder, flags, os, lineIndent);
+    AutoArgParse::printUsageHelp(flagInsertionOrder, os, lineIndent);
     lineIndent.indentLevel--;
 }
 
+AUTOARGPARSE_INLINE const std::string& PrintGroup::usageHelp(
+    size_t width) const {
+    argParser.buildLazyFlags();
+    return cachedHelp.get(argParser.getSchema().numberTokens, width, "",
+                          [this](std::ostream& os) { renderUsageHelp(os); });
+}
+
 AUTOARGPARSE_INLINE void PrintGroup::printUsageHelp(std::ostream& os) const {
+    detail::writeAll(os, usageHelp(terminalWidth(os)));
+}
+
+AUTOARGPARSE_INLINE void PrintGroup::renderUsageHelp(std::ostream& os) const {
     IndentedLine lineIndent(0);
     if (isDefaultGroup) {
         argParser.printUsageHelp(os, lineIndent);
@@ -155,14 +355,16 @@ AUTOARGPARSE_INLINE void PrintGroup::printUsageHelp(std::ostream& os) const {
         if (argPtr->description.size() > 0) {
             os << lineIndent;
             os << argPtr->name;
+            if (argPtr->collectsValues()) {
+                os << "...";
+            }
             if (argPtr->policy == Policy::OPTIONAL) {
                 os << " [optional]";
             }
-            std::cout << ": " << argPtr->description;
+            os << ": " << argPtr->description;
         }
     }
-    AutoArgParse::printUsageHelp(flagsToPrint, argParser.store.flags, os,
-                                 lineIndent);
+    AutoArgParse::printUsageHelp(flagsToPrint, os, lineIndent);
 }
 
 AUTOARGPARSE_INLINE void ArgParser::printSuccessfullyParsed(
@@ -173,54 +375,487 @@ AUTOARGPARSE_INLINE void ArgParser::printSuccessfullyParsed(
     }
 }
 
+AUTOARGPARSE_INLINE void ArgParser::parseArgs(const int argc,
+                                              const char** argv,
+                                              ParseResults& results) const {
+    parseCommandLine(*this, argc, argv, results);
+}
+
+/**
+ * Only a parser that may be modified, see tryValidateArgs(), builds the lazy
+ * flags named by the command line, a const one requires them built (see
+ * prepareNamedLazyFlags()).
+ */
+template <typename Parser>
+AUTOARGPARSE_INLINE void ArgParser::parseCommandLine(Parser& parser,
+                                                     const int argc,
+                                                     const char** argv,
+                                                     ParseResults& results) {
+#if AUTOARGPARSE_STATS
+    const auto start = std::chrono::steady_clock::now();
+#endif
+    const Schema& schema = parser.schema;
+    results.prepare(schema);
+    results.conversionPool = parser.conversionPool;
+    // argv[0] is kept so that flags can always look back at their own token
+    results.tokens.emplace_back((argc > 0) ? argv[0] : "");
+    results.numberTokensParsed = 1;
+    ArgIter first, last;
+    bool tokensAppended = false;
+#if AUTOARGPARSE_EXCEPTIONS
+    // parsing reports failures through results, only triggers and converters
+    // may still throw
+    try {
+#endif
+        const bool lazy = !schema.lazyFlags.empty();
+        // names of the lazy flags built may change how tokens split, so they
+        // are then split once those are built
+        const bool buildsLazyFlags = lazy && !std::is_const<Parser>::value;
+        bool appended =
+            parser.appendAllTokens(argc, argv, results, !buildsLazyFlags);
+        if (appended && lazy) {
+            appended = parser.prepareNamedLazyFlags(results);
+        }
+        if (!appended) {
+#if AUTOARGPARSE_STATS
+            parser.reportStats(results, start);
+#endif
+            return;
+        }
+        results.classifyTokens(schema);
+        first = results.tokens.begin() + 1;
+        last = results.tokens.end();
+        tokensAppended = true;
+        results.markParsed(parser);
+        if (parser.parse(results, first, last) && first != last) {
+            results.fail(UNEXPECTED_ARG, first).store = &parser.store;
+        }
+#if AUTOARGPARSE_EXCEPTIONS
+    } catch (...) {
+        results.error = std::current_exception();
+        AUTOARGPARSE_COUNT(results, exceptionsThrown, 1);
+    }
+#endif
+    if (tokensAppended) {
+        results.numberTokensParsed =
+            (int)std::distance(results.tokens.begin(), first);
+    }
+    results.convertDeferred();
+#if AUTOARGPARSE_STATS
+    parser.reportStats(results, start);
+#endif
+}
+
+#if AUTOARGPARSE_STATS
+AUTOARGPARSE_INLINE void ArgParser::reportStats(
+    ParseResults& results,
+    std::chrono::steady_clock::time_point start) const {
+    results.stats.nanoseconds = detail::nanosecondsSince(start);
+    if (statsSink) {
+        statsSink(results.stats);
+    }
+}
+#endif
+
+AUTOARGPARSE_INLINE void ParseResults::convertDeferred() {
+    if (deferred.empty()) {
+        return;
+    }
+    AUTOARGPARSE_COUNT(*this, conversions, deferred.size());
+    conversionPool->run(deferred.size(), [this](size_t i) {
+        DeferredConversion& conversion = deferred[i];
+#if AUTOARGPARSE_EXCEPTIONS
+        try {
+#endif
+            conversion.converted = conversion.arg->convertToken(
+                *this, tokens[conversion.tokenIndex], conversion.error);
+#if AUTOARGPARSE_EXCEPTIONS
+        } catch (...) {
+            conversion.exception = std::current_exception();
+        }
+#endif
+    });
+    size_t firstFailed = 0;
+    while (firstFailed < deferred.size() && deferred[firstFailed].converted) {
+        ++firstFailed;
+    }
+    if (firstFailed == deferred.size()) {
+        return;
+    }
+    // parsing would have stopped at the first failed conversion, forget
+    // everything parsed from there on, failed args hold no value
+    for (size_t i = firstFailed; i < deferred.size(); i++) {
+        if (!deferred[i].converted) {
+            parsedEntries[deferred[i].parsedIndex].destroy = NULL;
+        }
+    }
+    DeferredConversion& conversion = deferred[firstFailed];
+    for (size_t i = conversion.parsedIndex; i < parsedEntries.size(); i++) {
+        forget(parsedEntries[i]);
+    }
+    parsedInOrder.resize(conversion.parsedIndex);
+    parsedEntries.resize(conversion.parsedIndex);
+    numberTokensParsed = (int)conversion.tokenIndex;
+    helpRequested = false;
+    failed = false;
+    failure = ParseFailure();
+#if AUTOARGPARSE_EXCEPTIONS
+    error = conversion.exception;
+    if (error) {
+        AUTOARGPARSE_COUNT(*this, exceptionsThrown, 1);
+        return;
+    }
+#endif
+    ParseFailure& reported =
+        fail(FAILED_ARG_CONVERSION, tokens.begin() + conversion.tokenIndex);
+    reported.name = conversion.arg->name;
+    reported.explanation = std::move(conversion.error);
+}
+
+/** Returns false if a response file could not be read.  Combined flags are
+ * split if `splitCombined`, see splitCombinedFlags() otherwise. */
+AUTOARGPARSE_INLINE bool ArgParser::appendAllTokens(const int argc,
+                                                    const char** argv,
+                                                    ParseResults& results,
+                                                    bool splitCombined) const {
+    for (int i = 1; i < argc; i++) {
+        if (!appendTokens(argv[i], results, 0, splitCombined)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** Replace the tokens after argv[0] by `unsplit`, combined flags split. */
+AUTOARGPARSE_INLINE void ArgParser::splitCombinedFlags(
+    const std::vector<StringView>& unsplit, ParseResults& results) const {
+    results.clearTokens();
+    for (StringView token : unsplit) {
+        if (!appendCombinedFlag(token, results)) {
+            results.tokens.push_back(token);
+        }
+    }
+}
+
+/**
+ * Build the lazy flags named by the tokens, then those named among the flags
+ * just built, until none is left.  This happens before parsing as results
+ * cannot grow once args hold values.  A token naming a lazy flag elsewhere in
+ * the tree builds it needlessly, which is harmless.  With combined flags the
+ * tokens come unsplit and are split again with the names of each round, the
+ * views of the first pass being kept: response files are tokenised in place,
+ * so cannot be tokenised twice.
+ */
+AUTOARGPARSE_INLINE bool ArgParser::prepareNamedLazyFlags(
+    ParseResults& results) {
+    std::vector<StringView> unsplit;
+    if (combinedFlagsEnabled) {
+        unsplit.assign(results.tokens.begin() + 1, results.tokens.end());
+    }
+    std::vector<FlagBase*> named;
+    bool builtAny = false;
+    do {
+        if (combinedFlagsEnabled) {
+            splitCombinedFlags(unsplit, results);
+        }
+        named.clear();
+        for (size_t i = 1; i < results.tokens.size(); i++) {
+            auto range = schema.lazyFlags.equal_range(results.tokens[i]);
+            for (auto found = range.first; found != range.second; ++found) {
+                if (!found->second->built()) {
+                    named.push_back(found->second);
+                }
+            }
+        }
+        // building adds to lazyFlags, so not while iterating over it
+        for (FlagBase* flag : named) {
+            flag->build();
+        }
+        builtAny = builtAny || !named.empty();
+    } while (!named.empty());
+    if (builtAny) {
+        results.fit(schema);
+    }
+    return true;
+}
+
+/** The schema is left untouched, so the first token naming a lazy flag not
+ * built yet fails the results. */
+AUTOARGPARSE_INLINE bool ArgParser::prepareNamedLazyFlags(
+    ParseResults& results) const {
+    for (size_t i = 1; i < results.tokens.size(); i++) {
+        auto range = schema.lazyFlags.equal_range(results.tokens[i]);
+        for (auto found = range.first; found != range.second; ++found) {
+            if (!found->second->built()) {
+                results.fail(LAZY_FLAG_NOT_BUILT, results.tokens.begin() + i);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+AUTOARGPARSE_INLINE void ArgParser::buildLazyFlags() {
+    while (!schema.lazyFlags.empty()) {
+        FlagBase* flag = schema.lazyFlags.begin()->second;
+        schema.lazyFlags.erase(schema.lazyFlags.begin());
+        flag->build();
+    }
+}
+
+AUTOARGPARSE_INLINE bool ArgParser::hasLazyFlagsToBuild() const {
+    for (const auto& lazy : schema.lazyFlags) {
+        if (!lazy.second->built()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+AUTOARGPARSE_INLINE bool ArgParser::appendTokens(StringView token,
+                                                 ParseResults& results,
+                                                 int depth,
+                                                 bool splitCombined) const {
+    static const int MAX_RESPONSE_FILE_DEPTH = 32;
+    static const std::string tooDeep =
+        "Response files nested too deeply, do they include each other?";
+    if (!responseFilesEnabled || token.size() < 2 || token[0] != '@') {
+        if (!combinedFlagsEnabled || !splitCombined ||
+            !appendCombinedFlag(token, results)) {
+            results.tokens.push_back(token);
+        }
+        return true;
+    }
+    StringView path = token.substr(1);
+    if (depth == MAX_RESPONSE_FILE_DEPTH) {
+        ParseFailure& failure =
+            results.fail(INVALID_RESPONSE_FILE, results.tokens.end());
+        failure.name = path;
+        failure.explanation = ConversionError::fromStatic(tooDeep);
+        return false;
+    }
+    results.responseFiles.emplace_back();
+    MappedFile& file = results.responseFiles.back();
+    std::string error;
+    if (!file.open(path.str(), error)) {
+        ParseFailure& failure =
+            results.fail(INVALID_RESPONSE_FILE, results.tokens.end());
+        failure.name = path;
+        failure.explanation = ConversionError(std::move(error));
+        return false;
+    }
+    ResponseFileTokenizer tokenizer(file.data(), file.size());
+    StringView nested;
+    while (tokenizer.next(nested)) {
+        if (!appendTokens(nested, results, depth + 1, splitCombined)) {
+            return false;
+        }
+    }
+    if (tokenizer.error()) {
+        ParseFailure& failure =
+            results.fail(INVALID_RESPONSE_FILE, results.tokens.end());
+        failure.name = path;
+        failure.explanation = ConversionError(tokenizer.error());
+        return false;
+    }
+    return true;
+}
+
+AUTOARGPARSE_INLINE bool ArgParser::appendCombinedFlag(
+    StringView token, ParseResults& results) const {
+    if (token.size() < 3 || token[0] != '-' || schema.findFlagName(token)) {
+        return false;
+    }
+    size_t equals = token.find('=');
+    if (equals != StringView::npos &&
+        schema.findFlagName(token.substr(0, equals))) {
+        results.tokens.push_back(token.substr(0, equals));
+        results.markAttachedValue(results.tokens.size());
+        results.tokens.push_back(token.substr(equals + 1));
+        return true;
+    }
+    if (token[1] == '-') {
+        return false;
+    }
+    // only split clusters made entirely of flags, up to the value if any
+    size_t end = 1;
+    while (end < token.size()) {
+        const FlagBase* found = schema.findFlagName(
+            detail::shortFlagName(static_cast<unsigned char>(token[end++])));
+        if (!found) {
+            return false;
+        }
+        const FlagStore* nested = found->getNestedStore();
+        if (nested && !nested->args.empty()) {
+            break;
+        }
+    }
+    for (size_t i = 1; i < end; i++) {
+        results.tokens.push_back(
+            detail::shortFlagName(static_cast<unsigned char>(token[i])));
+    }
+    if (end < token.size()) {
+        results.markAttachedValue(results.tokens.size());
+        results.tokens.push_back(token.substr(end));
+    }
+    return true;
+}
+
+AUTOARGPARSE_INLINE std::string ParseResults::errorMessage() const {
+    if (!failed) {
+        return "";
+    }
+    StringView token = (failure.tokenIndex < tokens.size())
+                           ? tokens[failure.tokenIndex]
+                           : StringView();
+    switch (failure.reason) {
+        case MISSING_MANDATORY_FLAG:
+            return MissingMandatoryFlagException::makeErrorMessage(
+                *failure.store, *this);
+        case REPEATED_FLAG:
+            return RepeatedFlagException::makeErrorMessage(token);
+        case MISSING_MANDATORY_ARG:
+            return MissingMandatoryArgException::makeErrorMessage(
+                *failure.store, *this);
+        case UNEXPECTED_ARG:
+            return UnexpectedArgException::makeErrorMessage(
+                token, *failure.store, *this);
+        case MORE_THAN_ONE_EXCLUSIVE_ARG:
+            return MoreThanOneExclusiveArgException::makeErrorMessage(
+                failure.name, token, *failure.exclusiveFlags);
+        case FAILED_ARG_CONVERSION:
+            return FailedArgConversionException::makeErrorMessage(
+                failure.name, failure.explanation.message());
+        case INVALID_RESPONSE_FILE:
+            return ResponseFileException::makeErrorMessage(
+                failure.name, failure.explanation.message());
+        case LAZY_FLAG_NOT_BUILT:
+            return LazyFlagNotBuiltException::makeErrorMessage(token);
+    }
+    return "";
+}
+
+AUTOARGPARSE_INLINE void ParseResults::rethrow() const {
+#if AUTOARGPARSE_EXCEPTIONS
+    if (error) {
+        std::rethrow_exception(error);
+    }
+#endif
+    if (!failed) {
+        return;
+    }
+    StringView token = (failure.tokenIndex < tokens.size())
+                           ? tokens[failure.tokenIndex]
+                           : StringView();
+    switch (failure.reason) {
+        case MISSING_MANDATORY_FLAG:
+            AUTOARGPARSE_THROW(
+                MissingMandatoryFlagException(*failure.store, *this));
+        case REPEATED_FLAG:
+            AUTOARGPARSE_THROW(RepeatedFlagException(token));
+        case MISSING_MANDATORY_ARG:
+            AUTOARGPARSE_THROW(
+                MissingMandatoryArgException(*failure.store, *this));
+        case UNEXPECTED_ARG:
+            AUTOARGPARSE_THROW(
+                UnexpectedArgException(token, *failure.store, *this));
+        case MORE_THAN_ONE_EXCLUSIVE_ARG:
+            AUTOARGPARSE_THROW(MoreThanOneExclusiveArgException(
+                failure.name, token, *failure.exclusiveFlags));
+        case FAILED_ARG_CONVERSION:
+            AUTOARGPARSE_THROW(FailedArgConversionException(
+                failure.name, failure.explanation.message()));
+        case INVALID_RESPONSE_FILE:
+            AUTOARGPARSE_THROW(ResponseFileException(
+                failure.name, failure.explanation.message()));
+        case LAZY_FLAG_NOT_BUILT:
+            AUTOARGPARSE_THROW(LazyFlagNotBuiltException(token));
+    }
+}
+
+AUTOARGPARSE_INLINE void ArgParser::printSuccessfullyParsed(
+    std::ostream& os, const ParseResults& results) const {
+    for (int i = 0; i < results.numberTokensParsed; i++) {
+        os << " " << results.tokens[i];
+    }
+}
+
+AUTOARGPARSE_INLINE const ParseResults& ArgParser::tryValidateArgs(
+    const int argc, const char** argv) {
+    reset();
+    parseCommandLine(*this, argc, argv, lastResults);
+    // the parsed tokens belong to this parser, the results only refer to them
+    // as const since parsing never modifies them
+    for (const ParseToken* token : lastResults.getParsedInOrder()) {
+        const_cast<ParseToken*>(token)->commit(lastResults);
+    }
+    numberArgsSuccessfullyParsed = lastResults.numberTokensParsed;
+    return lastResults;
+}
+
 AUTOARGPARSE_INLINE void ArgParser::validateArgs(const int argc,
                                                  const char** argv,
                                                  bool handleError) {
-    stringArgs.assign(argv + 1, argv + argc);
-    using std::begin;
-
-    using std::end;
-    auto first = begin(stringArgs);
-    auto last = end(stringArgs);
-    try {
-        parse(first, last);
-        if (first != last) {
-            throw UnexpectedArgException(*first, this->getFlagStore());
-        }
-        numberArgsSuccessfullyParsed =
-            std::distance(begin(stringArgs), first) + 1;
-    } catch (ParseException& e) {
-        numberArgsSuccessfullyParsed =
-            std::distance(begin(stringArgs), first) + 1;
-        if (!handleError) {
-            throw;
-        }
-        std::cerr << "Error: " << e.what() << std::endl;
-        std::cerr << "Successfully parsed: ";
-        printSuccessfullyParsed(std::cerr, argv);
-        std::cerr << "\n\n";
-        printAllUsageInfo(std::cerr, argv[0]);
-        exit(1);
-    } catch (HelpFlagTriggeredException& e) {
-        if (first[-1] == std::string("--help")) {
-            printAllUsageInfo(std::cout, argv[0]);
+    const ParseResults& results = tryValidateArgs(argc, argv);
+    if (results.succeeded()) {
+        return;
+    }
+    if (results.helpRequested) {
+        size_t width = terminalWidth(std::cout);
+        std::string help;
+        // groups named after --help, in the order they were given
+        for (const ParseToken* token : results.getParsedInOrder()) {
+            for (auto& pg : printGroups) {
+                if (pg.helpFlag == token) {
+                    help += pg.usageHelp(width);
+                }
+            }
+        }
+        if (results.tokens[numberArgsSuccessfullyParsed - 1] ==
+            StringView("--help")) {
+            help += usageInfo(argv[0], width);
         }
+        detail::writeAll(std::cout, help);
         exit(0);
     }
+    if (!handleError || !results.failed) {
+        results.rethrow();
+    }
+    std::ostringstream os;
+    os << "Error: " << results.errorMessage() << "\n";
+    os << "Successfully parsed: ";
+    printSuccessfullyParsed(os, results);
+    os << "\n\n";
+    os << usageInfo(argv[0], terminalWidth(std::cerr));
+    detail::writeAll(std::cerr, os.str());
+    exit(1);
 }
 
 AUTOARGPARSE_INLINE void ArgParser::printAllUsageInfo(
     std::ostream& os, const std::string& programName) {
+    detail::writeAll(os, usageInfo(programName, terminalWidth(os)));
+}
+
+AUTOARGPARSE_INLINE const std::string& ArgParser::usageInfo(
+    const std::string& programName, size_t width) {
+    buildLazyFlags();
     if (helpFlag && firstTimePrinting) {
         firstTimePrinting = false;
         // help flag would have been the first thing added, move it to the end.
         store.rotateLeft();
     }
+    return cachedUsage.get(
+        schema.numberTokens, width, programName,
+        [&](std::ostream& os) { renderUsageInfo(os, programName); });
+}
+
+AUTOARGPARSE_INLINE void ArgParser::renderUsageInfo(
+    std::ostream& os, const std::string& programName) const {
     os << "Usage: " << programName;
     printUsageSummary(os);
     os << "\n\nArguments:\n";
     if (printGroups.size() == 1) {
-        printGroups.at(0).printUsageHelp(os);
+        printGroups.at(0).renderUsageHelp(os);
         return;
     }
     os << "The options are divided into the following groups.  Use --help "
@@ -231,32 +866,447 @@ AUTOARGPARSE_INLINE void ArgParser::printAllUsageInfo(
             first = false;
             continue;
         }
-        os << pg.getName() << "  -- " << pg.getDescription() << std::endl;
+        os << pg.getName() << "  -- " << pg.getDescription() << "\n";
     }
     if (helpFlag) {
         os << "--help prints this message.\n";
     }
 }
 
-AUTOARGPARSE_INLINE void throwFailedArgConversionException(
-    const std::string& name, const std::string& additionalExpl) {
-    throw FailedArgConversionException(name, additionalExpl);
-}
 
-AUTOARGPARSE_INLINE void throwMoreThanOneExclusiveArgException(
-    const std::string& conflictingFlag1, const std::string& conflictingFlag2,
-    const std::deque<std::string>& exclusiveFlags) {
-    throw MoreThanOneExclusiveArgException(conflictingFlag1, conflictingFlag2,
-                                           exclusiveFlags);
+AUTOARGPARSE_INLINE void ExclusiveGroupBase::join(FlagStore& store,
+                                                  FlagBase& flag) {
+    flag.exclusiveGroup = this;
+    // printed and required through the group rather than on their own
+    flags.push_back(flag.name);
+    members.push_back(store.flagInsertionOrder.back());
+    store.flagInsertionOrder.pop_back();
+    store.mandatoryFlags.erase(flag.slot);
+    memberSlots.insert(flag.slot);
+    if (flags.size() > 1) {
+        if (policy == Policy::MANDATORY) {
+            --store._numberMandatoryFlags;
+        } else {
+            --store._numberOptionalFlags;
+        }
+    }
 }
 
 AUTOARGPARSE_INLINE void FlagStore::rotateLeft() {
     if (flagInsertionOrder.empty()) {
         return;
     }
-    auto flag = std::move(flagInsertionOrder.front());
-    flagInsertionOrder.pop_front();
-    flagInsertionOrder.emplace_back(std::move(flag));
+    std::rotate(flagInsertionOrder.begin(), flagInsertionOrder.begin() + 1,
+                flagInsertionOrder.end());
+}
+
+AUTOARGPARSE_INLINE void FlagStore::attach(Schema* newSchema) {
+    schema = newSchema;
+    arena = (schema) ? &schema->arena : NULL;
+    if (schema) {
+        cursorOffset = schema->addValue(sizeof(size_t), alignof(size_t));
+    }
+    flags = FlagMap(0, StringViewHash(), std::equal_to<StringView>(),
+                    allocator<FlagMap::value_type>());
+    flagIndex.clear();
+    groups = decltype(groups)(allocator<FlagPtr>());
+    flagSlots = decltype(flagSlots)(allocator<const FlagBase*>());
+    mandatoryFlags = FlagSet();
+    flagInsertionOrder = FlagList(allocator<const FlagBase*>());
+    args = ArgVector(allocator<ArgPtr>());
+}
+
+AUTOARGPARSE_INLINE void FlagStore::freeze(FrozenSchema& frozen) {
+    for (const FlagBase* flag : flagSlots) {
+        if (!flag->isExclusiveGroup()) {
+            frozen.addFlag(flag->name, flag);
+        }
+    }
+    frozenStore = frozen.endStore();
+    flagIndex.clear();
+    for (FlagBase* flag : flagSlots) {
+        FlagStore* nested = flag->getNestedStore();
+        // lazy flags built later keep their own index
+        if (nested && flag->built()) {
+            nested->freeze(frozen);
+        }
+    }
+}
+
+AUTOARGPARSE_INLINE size_t FlagStore::indexBytesUsed() const {
+    size_t bytes = flagIndex.bytesUsed() + mandatoryFlags.bytesUsed();
+    for (const FlagBase* flag : flagSlots) {
+        const FlagStore* nested = flag->getNestedStore();
+        if (nested) {
+            bytes += nested->indexBytesUsed();
+        }
+    }
+    return bytes;
+}
+
+AUTOARGPARSE_INLINE void ArgParser::freeze() {
+    if (frozen()) {
+        return;
+    }
+    store.freeze(schema.frozen);
+    schema.flagNames.forEach([&](StringView name, const FlagBase* flag) {
+        schema.frozen.addFlag(name, flag);
+    });
+    schema.namesStore = schema.frozen.endStore();
+    schema.flagNames.clear();
+    schema.frozen.shrink();
+}
+
+namespace detail {
+/** Collects the records of a SchemaImage, see ArgParser::saveSchema(). */
+class SchemaImageWriter {
+    const SchemaBindings& bindings;
+    std::unordered_map<StringView, SchemaImage::String, StringViewHash>
+        interned;
+    std::unordered_map<const SchemaBindings::Binding*, uint32_t> bindingIndex;
+
+   public:
+    std::string strings;
+    std::vector<SchemaImage::String> bindingIds;
+    std::vector<SchemaImage::Node> nodes;
+    std::unordered_map<const ParseToken*, uint32_t> nodeIndex;
+    // node indexes of the args of the parser itself
+    std::vector<uint32_t> rootArgs;
+
+    explicit SchemaImageWriter(const SchemaBindings& bindings)
+        : bindings(bindings) {}
+
+    inline SchemaImage::String string(StringView str) {
+        auto found = interned.find(str);
+        if (found != interned.end()) {
+            return found->second;
+        }
+        SchemaImage::String added = {static_cast<uint32_t>(strings.size()),
+                                     static_cast<uint32_t>(str.size())};
+        strings.append(str.data(), str.size());
+        interned.emplace(str, added);
+        return added;
+    }
+
+    inline uint32_t binding(const ParseToken& node, StringView name) {
+        const SchemaBindings::Binding* found = bindings.find(node);
+        if (!found) {
+            AUTOARGPARSE_THROW(std::logic_error(
+                "No binding for the type of " + name.str() + "."));
+        }
+        auto added = bindingIndex.emplace(found, bindingIds.size());
+        if (added.second) {
+            bindingIds.push_back(string(found->id));
+        }
+        return added.first->second;
+    }
+
+    inline uint32_t addNode(const ParseToken& token, SchemaImage::Node node) {
+        node.policy = static_cast<uint8_t>(token.policy);
+        node.description = string(token.description);
+        nodeIndex[&token] = static_cast<uint32_t>(nodes.size());
+        nodes.push_back(node);
+        return static_cast<uint32_t>(nodes.size() - 1);
+    }
+
+    /** Add the nodes of `store` then those of the stores nested in it,
+     * leaving out the nested store of `skip`. */
+    void addStore(const FlagStore& store, uint32_t parent,
+                  const FlagBase* skip) {
+        for (const FlagBase* flag : store.flagSlots) {
+            SchemaImage::Node node = SchemaImage::Node();
+            node.parent = parent;
+            if (flag->isExclusiveGroup()) {
+                node.kind = SchemaImage::GROUP_NODE;
+            } else {
+                node.kind = SchemaImage::FLAG_NODE;
+                node.requestsHelp = flag->requestsHelp;
+                node.binding = binding(*flag, flag->name);
+                node.name = string(flag->name);
+                if (flag->exclusiveGroup) {
+                    node.group = nodeIndex[flag->exclusiveGroup] + 1;
+                }
+            }
+            addNode(*flag, node);
+        }
+        for (const auto& arg : store.args) {
+            SchemaImage::Node node = SchemaImage::Node();
+            node.kind = SchemaImage::ARG_NODE;
+            node.parent = parent;
+            node.binding = binding(*arg, arg->name);
+            node.name = string(arg->name);
+            uint32_t index = addNode(*arg, node);
+            if (parent == 0) {
+                rootArgs.push_back(index);
+            }
+        }
+        for (const FlagBase* flag : store.flagSlots) {
+            const FlagStore* nested = flag->getNestedStore();
+            if (nested && flag != skip) {
+                addStore(*nested, nodeIndex[flag] + 1, skip);
+            }
+        }
+    }
+};
+
+template <typename T>
+inline void writeRecords(std::ostream& os, const T* records, size_t number) {
+    os.write(reinterpret_cast<const char*>(records), sizeof(T) * number);
+}
+
+/** Reads the records of a SchemaImage, checking they are within it. */
+class SchemaImageReader {
+    StringView image;
+
+    [[noreturn]] static inline void invalid(const std::string& why) {
+        AUTOARGPARSE_THROW(
+            std::invalid_argument("Not a valid schema image: " + why));
+    }
+
+   public:
+    SchemaImage::Header header;
+    size_t bindingsOffset, nodesOffset, printGroupsOffset, membersOffset,
+        stringsOffset;
+
+    explicit SchemaImageReader(StringView image) : image(image) {
+        if (image.size() < sizeof(header)) {
+            invalid("too short.");
+        }
+        std::memcpy(&header, image.data(), sizeof(header));
+        if (std::memcmp(header.magic, SchemaImage::magic(), 4) != 0 ||
+            header.version != SchemaImage::VERSION) {
+            invalid("wrong magic number or version.");
+        }
+        bindingsOffset = sizeof(header);
+        nodesOffset = bindingsOffset + size_t(header.numberBindings) *
+                                           sizeof(SchemaImage::String);
+        printGroupsOffset = nodesOffset + size_t(header.numberNodes) *
+                                              sizeof(SchemaImage::Node);
+        membersOffset = printGroupsOffset + size_t(header.numberPrintGroups) *
+                                                sizeof(SchemaImage::PrintGroup);
+        stringsOffset =
+            membersOffset + size_t(header.numberMembers) * sizeof(uint32_t);
+        if (stringsOffset + header.stringsSize != image.size()) {
+            invalid("wrong size.");
+        }
+    }
+
+    template <typename T>
+    inline T read(size_t offset, size_t index) const {
+        T record;
+        std::memcpy(&record, image.data() + offset + index * sizeof(T),
+                    sizeof(T));
+        return record;
+    }
+
+    inline StringView string(SchemaImage::String str) const {
+        if (size_t(str.offset) + str.size > header.stringsSize) {
+            invalid("string out of bounds.");
+        }
+        return StringView(image.data() + stringsOffset + str.offset, str.size);
+    }
+
+    inline void check(bool valid, const char* why) const {
+        if (!valid) {
+            invalid(why);
+        }
+    }
+};
+}  // namespace detail
+
+AUTOARGPARSE_INLINE void ArgParser::saveSchema(
+    std::ostream& os, const SchemaBindings& bindings) const {
+    detail::SchemaImageWriter writer(bindings);
+    writer.addStore(store, 0, helpFlag);
+    std::vector<SchemaImage::PrintGroup> groups;
+    std::vector<uint32_t> members;
+    for (const PrintGroup& pg : printGroups) {
+        if (pg.isDefaultGroup) {
+            continue;
+        }
+        SchemaImage::PrintGroup group;
+        group.name = writer.string(pg.name);
+        group.description = writer.string(pg.description);
+        group.firstMember = static_cast<uint32_t>(members.size());
+        for (const FlagBase* flag : pg.flagsToPrint) {
+            members.push_back(writer.nodeIndex[flag]);
+        }
+        for (size_t index : pg.argsToPrint) {
+            members.push_back(writer.rootArgs[index]);
+        }
+        group.numberMembers =
+            static_cast<uint32_t>(members.size() - group.firstMember);
+        groups.push_back(group);
+    }
+    SchemaImage::Header header;
+    std::memcpy(header.magic, SchemaImage::magic(), 4);
+    header.version = SchemaImage::VERSION;
+    header.numberBindings = static_cast<uint32_t>(writer.bindingIds.size());
+    header.numberNodes = static_cast<uint32_t>(writer.nodes.size());
+    header.numberPrintGroups = static_cast<uint32_t>(groups.size());
+    header.numberMembers = static_cast<uint32_t>(members.size());
+    header.stringsSize = static_cast<uint32_t>(writer.strings.size());
+    detail::writeRecords(os, &header, 1);
+    detail::writeRecords(os, writer.bindingIds.data(),
+                         writer.bindingIds.size());
+    detail::writeRecords(os, writer.nodes.data(), writer.nodes.size());
+    detail::writeRecords(os, groups.data(), groups.size());
+    detail::writeRecords(os, members.data(), members.size());
+    os.write(writer.strings.data(), writer.strings.size());
+}
+
+AUTOARGPARSE_INLINE void ArgParser::loadSchema(
+    StringView image, const SchemaBindings& bindings) {
+    if (!store.flagSlots.empty() || !store.args.empty()) {
+        AUTOARGPARSE_THROW(std::logic_error(
+            "loadSchema() needs an empty ArgParser, see ArgParser(false)."));
+    }
+    detail::SchemaImageReader reader(image);
+    const SchemaImage::Header& header = reader.header;
+    std::vector<const SchemaBindings::Binding*> bound(header.numberBindings);
+    for (size_t i = 0; i < bound.size(); i++) {
+        StringView id = reader.string(
+            reader.read<SchemaImage::String>(reader.bindingsOffset, i));
+        bound[i] = bindings.find(id.str());
+        if (!bound[i]) {
+            AUTOARGPARSE_THROW(
+                std::logic_error("No binding named " + id.str() + "."));
+        }
+    }
+    // what each node became, and the position of the args of the parser
+    // itself, unused for other nodes
+    std::vector<ParseToken*> nodes(header.numberNodes);
+    std::vector<size_t> rootArgPositions(header.numberNodes);
+    for (size_t i = 0; i < nodes.size(); i++) {
+        const SchemaImage::Node node =
+            reader.read<SchemaImage::Node>(reader.nodesOffset, i);
+        reader.check(node.parent <= i && node.kind <= SchemaImage::ARG_NODE &&
+                         node.policy <= Policy::OPTIONAL,
+                     "node out of order or of an unknown kind.");
+        FlagStore* parent = &store;
+        if (node.parent != 0) {
+            FlagBase* flag = dynamic_cast<FlagBase*>(nodes[node.parent - 1]);
+            parent = (flag) ? flag->getNestedStore() : NULL;
+        }
+        reader.check(parent != NULL, "node under a flag without a store.");
+        const Policy policy = static_cast<Policy>(node.policy);
+        StringView name = reader.string(node.name);
+        StringView description = reader.string(node.description);
+        if (node.kind == SchemaImage::GROUP_NODE) {
+            nodes[i] = &parent->insertGroup(FlagPtr(
+                parent->create<ExclusiveGroupBase>(
+                    policy, NameList(parent->allocator<StringView>()),
+                    FlagList(parent->allocator<const FlagBase*>())),
+                parent->deleter()));
+            continue;
+        }
+        reader.check(node.binding < bound.size() &&
+                         bound[node.binding]->isArg ==
+                             (node.kind == SchemaImage::ARG_NODE),
+                     "node with the wrong binding.");
+        ParseToken* created =
+            bound[node.binding]->create(*parent, policy, name, description);
+        if (node.kind == SchemaImage::ARG_NODE) {
+            if (node.parent == 0) {
+                rootArgPositions[i] = parent->args.size();
+            }
+            nodes[i] = &parent->addArg(
+                ArgPtr(static_cast<ArgBase*>(created), parent->deleter()));
+            continue;
+        }
+        FlagBase& flag = *parent->addFlag(
+            name,
+            FlagPtr(static_cast<FlagBase*>(created), parent->deleter()));
+        nodes[i] = &flag;
+        if (node.requestsHelp) {
+            flag.requestsHelp = true;
+            if (node.parent == 0 && !helpFlag) {
+                helpFlag = dynamic_cast<ComplexFlag<DoNothingTrigger>*>(&flag);
+            }
+        }
+        if (node.group != 0) {
+            reader.check(node.group <= i &&
+                             nodes[node.group - 1]->policy == policy,
+                         "flag in an invalid group.");
+            ExclusiveGroupBase* group =
+                dynamic_cast<ExclusiveGroupBase*>(nodes[node.group - 1]);
+            reader.check(group != NULL, "flag in an invalid group.");
+            group->join(*parent, flag);
+        }
+    }
+    for (size_t i = 0; i < header.numberPrintGroups; i++) {
+        const SchemaImage::PrintGroup group =
+            reader.read<SchemaImage::PrintGroup>(reader.printGroupsOffset, i);
+        reader.check(size_t(group.firstMember) + group.numberMembers <=
+                         header.numberMembers,
+                     "print group out of bounds.");
+        PrintGroup& pg = makePrintGroup(reader.string(group.name).str(),
+                                        reader.string(group.description).str());
+        for (size_t j = 0; j < group.numberMembers; j++) {
+            uint32_t index = reader.read<uint32_t>(reader.membersOffset,
+                                                   group.firstMember + j);
+            reader.check(index < nodes.size(), "print group out of bounds.");
+            // print groups hold flags and args of the parser itself, exclusive
+            // groups and their flags excepted
+            const SchemaImage::Node member =
+                reader.read<SchemaImage::Node>(reader.nodesOffset, index);
+            reader.check(member.parent == 0 && member.group == 0 &&
+                             member.kind != SchemaImage::GROUP_NODE,
+                         "print group member not a flag or arg of the parser.");
+            if (member.kind == SchemaImage::FLAG_NODE) {
+                pg.flagsToPrint.push_back(static_cast<FlagBase*>(nodes[index]));
+            } else {
+                pg.argsToPrint.push_back(rootArgPositions[index]);
+            }
+        }
+    }
+}
+
+AUTOARGPARSE_INLINE ParseToken* ArgParser::findNode(StringView path) {
+    FlagStore* current = &store;
+    ParseToken* found = this;
+    size_t begin = 0;
+    while (begin <= path.size()) {
+        size_t end = path.find(' ', begin);
+        if (end == StringView::npos) {
+            end = path.size();
+        }
+        StringView name = path.substr(begin, end - begin);
+        begin = end + 1;
+        if (!current) {
+            return NULL;
+        }
+        auto flag = current->flags.find(name);
+        if (flag != current->flags.end()) {
+            flag->second->build();
+            found = flag->second.get();
+            current = flag->second->getNestedStore();
+            continue;
+        }
+        found = NULL;
+        for (auto& arg : current->args) {
+            if (arg->name == name) {
+                found = arg.get();
+                break;
+            }
+        }
+        // args hold nothing, they end the path
+        if (!found || begin <= path.size()) {
+            return NULL;
+        }
+    }
+    return found;
+}
+
+AUTOARGPARSE_INLINE void ArgParser::reset() {
+    for (const ParseToken* token : lastResults.getParsedInOrder()) {
+        if (token != this) {
+            const_cast<ParseToken*>(token)->reset();
+        }
+    }
+    ComplexFlag<DoNothingTrigger>::reset();
+    lastResults.clear();
+    numberArgsSuccessfullyParsed = 0;
 }
 } /* namespace AutoArgParse */
 #endif /* AUTOARGPARSE_ARGPARSER_CPP_ */
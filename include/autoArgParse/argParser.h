@@ -1,30 +1,36 @@
 #ifndef AUTOARGPARSE_ARGPARSER_H_
 #define AUTOARGPARSE_ARGPARSER_H_
+#include <functional>
 #include "argHandlers.h"
 #include "argParserBase.h"
 #include "args.h"
 #include "flags.h"
+#include "helpText.h"
 #include "indentedLine.h"
+#include "responseFile.h"
+#include "schemaImage.h"
 
 namespace AutoArgParse {
 class ArgParser;
 class PrintGroup;
 
 class PrintGroup {
+    friend ArgParser;
     ArgParser& argParser;
     std::string name;
     std::string description;
-    std::deque<std::string> flagsToPrint;
+    FlagList flagsToPrint;
     std::vector<size_t> argsToPrint;
     bool isDefaultGroup;
+    // the flag under --help naming this group, if any
+    const FlagBase* helpFlag = NULL;
+    mutable detail::CachedText cachedHelp;
+
+    void renderUsageHelp(std::ostream& os) const;
 
    public:
     PrintGroup(ArgParser& argParser, const std::string& name,
-               const std::string& description, bool isDefaultGroup = false)
-        : argParser(argParser),
-          name(name),
-          description(description),
-          isDefaultGroup(isDefaultGroup) {}
+               const std::string& description, bool isDefaultGroup = false);
     inline bool active() const {
         return !argsToPrint.empty() || !flagsToPrint.empty();
     }
@@ -44,43 +50,256 @@ class PrintGroup {
     template <typename ArgType,
               typename ConverterFunc = Converter<typename ArgType::ValueType>,
               typename ArgValueType = typename ArgType::ValueType>
-    typename std::enable_if<std::is_base_of<ArgBase, ArgType>::value,
-                            Arg<ArgValueType, ConverterFunc>&>::type
+    typename std::enable_if<
+        std::is_base_of<ArgBase, ArgType>::value,
+        typename ArgType::template WithConverter<ConverterFunc>&>::type
     add(const std::string& name, const Policy policy,
         const std::string& description,
         ConverterFunc&& convert = Converter<ArgValueType>());
 
+    /** The help of this group, rendered once and wrapped at `width` columns
+     * (0 for no wrapping). */
+    const std::string& usageHelp(size_t width = 0) const;
+
+    /** Write usageHelp() with one write, wrapped to the terminal if `os` is
+     * one.*/
     void printUsageHelp(std::ostream& os) const;
     ExclusiveFlagGroup<DoNothingTrigger>& makeExclusiveGroup(Policy);
 };
 
-class ArgParser : public ComplexFlag<DoNothingTrigger> {
-    struct HelpFlagTriggeredException {};
-    struct HelpFlagTrigger {
-        ArgParser& argParser;
-        HelpFlagTrigger(ArgParser& argParser) : argParser(argParser) {}
-        void operator()(const std::string&) {
-            throw HelpFlagTriggeredException();
-        }
-    };
+namespace detail {
+/** Holds the schema of an ArgParser.  Inherited before ComplexFlag so that
+ * the arena outlives every node allocated in it.*/
+struct SchemaOwner {
+    Schema schema;
+};
+}  // namespace detail
 
+class ArgParser : private detail::SchemaOwner,
+                  public ComplexFlag<DoNothingTrigger> {
     friend PrintGroup;
     int numberArgsSuccessfullyParsed = 0;
-    std::vector<std::string> stringArgs;
+    // outcome of the last validateArgs(), committed into the tokens
+    ParseResults lastResults;
     std::deque<PrintGroup> printGroups;
-    ComplexFlag<HelpFlagTrigger>* helpFlag = NULL;
+    ComplexFlag<DoNothingTrigger>* helpFlag = NULL;
     bool firstTimePrinting = true;
+    detail::CachedText cachedUsage;
+    bool responseFilesEnabled = false;
+    bool combinedFlagsEnabled = false;
+    ConversionPool* conversionPool = NULL;
+    std::function<void(const ParseStats&)> statsSink;
+
+    void renderUsageInfo(std::ostream& os,
+                         const std::string& programName) const;
+    bool appendTokens(StringView token, ParseResults& results, int depth,
+                      bool splitCombined) const;
+    bool appendCombinedFlag(StringView token, ParseResults& results) const;
+    bool appendAllTokens(const int argc, const char** argv,
+                         ParseResults& results, bool splitCombined) const;
+    void splitCombinedFlags(const std::vector<StringView>& unsplit,
+                            ParseResults& results) const;
+    // the lazy flags named by the tokens are built, or must have been if the
+    // parser is const; returns false if parsing must stop
+    bool prepareNamedLazyFlags(ParseResults& results);
+    bool prepareNamedLazyFlags(ParseResults& results) const;
+    template <typename Parser>
+    static void parseCommandLine(Parser& parser, const int argc,
+                                 const char** argv, ParseResults& results);
+#if AUTOARGPARSE_STATS
+    void reportStats(ParseResults& results,
+                     std::chrono::steady_clock::time_point start) const;
+#endif
 
    public:
     ArgParser(bool addHelpFlag = true);
 
+    /** The arena holding every flag, arg, name and description of this
+     * parser. */
+    inline const Arena& getArena() const { return schema.arena; }
+
+    inline const Schema& getSchema() const { return schema; }
+
+    /**
+     * Declare the schema complete.  The flags of every nested store are then
+     * looked up through one set of contiguous tables (see FrozenSchema)
+     * instead of an index per store.  Those indexes and the index of every
+     * flag name are released.  Adding a flag or arg afterwards is an error
+     * (std::logic_error).  Calling it again has no effect.
+     */
+    void freeze();
+
+    inline bool frozen() const {
+        return store.frozenStore != FrozenSchema::npos;
+    }
+
+    /** Memory held by the schema, by what it is used for. */
+    inline SchemaMemory schemaMemory() const {
+        SchemaMemory memory = schema.memory;
+        memory.containers = schema.arena.bytesUsed() - memory.names -
+                            memory.descriptions - memory.nodes -
+                            memory.converters;
+        memory.indexes = store.indexBytesUsed() + schema.frozen.bytesUsed() +
+                         schema.strings.bytesUsed() +
+                         schema.flagNames.bytesUsed() +
+                         schema.lazyFlags.bucket_count() * sizeof(void*) +
+                         schema.lazyFlags.size() *
+                             (sizeof(*schema.lazyFlags.begin()) +
+                              2 * sizeof(void*));
+        return memory;
+    }
+
+    /**
+     * Build every LazyFlag, those added while building included.
+     * validateArgs() only builds those its command line names and
+     * parseArgs() none, call this before it.  Printing usage builds them all
+     * too.
+     */
+    void buildLazyFlags();
+
+    /** Whether some LazyFlag is still to be built. */
+    bool hasLazyFlagsToBuild() const;
+
+    /** Memory held by the schema: the arena plus the flag indexes or, once
+     * frozen, the frozen tables, and the string pool. */
+    inline size_t schemaBytesUsed() const { return schemaMemory().total(); }
+
+    /**
+     * Write the schema (flags, args, policies, exclusive groups, print groups
+     * and descriptions) as a binary image, see SchemaImage.  loadSchema()
+     * turns it back into a parser.  It still creates and indexes every node,
+     * so its cost stays linear in their number, but uses names and
+     * descriptions in place instead of copying them.  The type of every flag
+     * and arg needs a binding in `bindings`, std::logic_error is thrown
+     * otherwise.  The flags under --help naming the print groups are left
+     * out, loadSchema() recreates them.
+     */
+    void saveSchema(std::ostream& os, const SchemaBindings& bindings) const;
+
+    /**
+     * Recreate the schema saved in `image` in this parser, which must be
+     * empty, i.e. constructed as ArgParser(false).  Names and descriptions
+     * are not copied: `image`, e.g. a MappedFile, must outlive the parser.
+     * Throws std::invalid_argument if `image` is not a valid image and
+     * std::logic_error if it names a binding missing from `bindings`.
+     */
+    void loadSchema(StringView image, const SchemaBindings& bindings);
+
+    /** The flag or arg at `path`, the names leading to it separated by
+     * spaces (e.g. "-p number_watts"), NULL if there is none. */
+    ParseToken* findNode(StringView path);
+
+    /** findNode() as a `Node`, e.g. after loadSchema().  Throws
+     * std::logic_error if there is no node of that type at `path`. */
+    template <typename Node>
+    inline Node& node(StringView path) {
+        Node* found = dynamic_cast<Node*>(findNode(path));
+        if (!found) {
+            AUTOARGPARSE_THROW(std::logic_error("No node of that type at " +
+                                                path.str() + "."));
+        }
+        return *found;
+    }
+
+    /** node() for an arg added as add<ArgType>(..., convert), e.g.
+     * parser.arg<Arg<int>>("-p number_watts").get(). */
+    template <typename ArgType,
+              typename ConverterFunc = Converter<typename ArgType::ValueType>>
+    inline typename ArgType::template WithConverter<ConverterFunc>& arg(
+        StringView path) {
+        return node<typename ArgType::template WithConverter<ConverterFunc>>(
+            path);
+    }
+
     inline int getNumberArgsSuccessfullyParsed() const {
         return numberArgsSuccessfullyParsed;
     }
     void printGroupHelp(std::string groupName);
+
+    /**
+     * Replace `@path` tokens by the tokens of the file at `path` (see
+     * ResponseFileTokenizer), which may name response files in turn.  The
+     * file is memory mapped and tokens refer to the mapping, the size of a
+     * command line is then no longer limited by the operating system.
+     */
+    inline void expandResponseFiles(bool enable = true) {
+        responseFilesEnabled = enable;
+    }
+
+    /**
+     * Split `--name=value` into the flag `--name` and its value, and clusters
+     * of short flags such as `-xvf` into `-x -v -f`.  In a cluster, a flag
+     * taking args takes the rest of the token as its value, e.g. `-j8` or
+     * `-vj8`.  A token is only split when the parts are flags of the parser
+     * (at any depth) and the token itself is not; the parts are views of the
+     * token, nothing is copied.  A value attached to a flag is never taken
+     * for a flag and must be consumed by that flag.
+     */
+    inline void expandCombinedFlags(bool enable = true) {
+        combinedFlagsEnabled = enable;
+    }
+
+    /**
+     * Convert in two phases: the command line is first matched against the
+     * schema, then the tokens of mandatory args are converted concurrently on
+     * `pool`.  Lists convert their values on `pool` while matching.  Errors
+     * are those of converting while matching: the first failed conversion on
+     * the command line is reported and what was parsed after it forgotten.
+     * Triggers of flags given after that arg still ran, and converters of
+     * different args run at the same time.  NULL, the default, converts while
+     * matching.  The pool must outlive its use by this parser.
+     */
+    inline void convertConcurrently(ConversionPool* pool) {
+        conversionPool = pool;
+    }
+
+    /**
+     * Pass the ParseStats of every command line parsed to `sink`, e.g. to
+     * export them as metrics.  The stats are also left in the ParseResults.
+     * Only called when built with AUTOARGPARSE_STATS=1, the sink must not
+     * throw.
+     */
+    inline void sendStatsTo(std::function<void(const ParseStats&)> sink) {
+        statsSink = std::move(sink);
+    }
+
+    /**
+     * Clear the results of the previous validateArgs(), leaving the schema in
+     * place.  Only the flags and args that were actually parsed are visited.
+     * Called by validateArgs() itself, so one parser may validate any number
+     * of command lines.
+     */
+    virtual void reset();
+
+    /**
+     * Parse a command line into the flags and args of this parser, neither
+     * throwing nor exiting.  Check succeeded() on the returned results, which
+     * otherwise tell whether --help was given or why the command line was
+     * rejected (failure, errorMessage()).  The results are kept until the
+     * next call.  The LazyFlags the command line names are built first.
+     */
+    const ParseResults& tryValidateArgs(const int argc, const char** argv);
+
+    /**
+     * tryValidateArgs(), then print usage and exit on --help.  Parse errors
+     * are printed along with usage and exit, or thrown as a ParseException if
+     * `handleError` is false.
+     */
     void validateArgs(const int argc, const char** argv,
                       bool handleError = true);
 
+    /**
+     * Parse a command line into `results`, leaving the parser and its tokens
+     * untouched; failures are recorded in results rather than thrown.  Safe
+     * to call from several threads at once as long as the schema is not
+     * modified meanwhile, triggers and converters must then be thread safe
+     * too.  LazyFlags are not built: a command line naming one not built yet
+     * fails with LAZY_FLAG_NOT_BUILT, see buildLazyFlags().  See also
+     * BatchParser.
+     */
+    void parseArgs(const int argc, const char** argv,
+                   ParseResults& results) const;
+
     void printSuccessfullyParsed(std::ostream& os, const char** argv,
                                  int numberParsed) const;
 
@@ -88,6 +307,19 @@ class ArgParser : public ComplexFlag<DoNothingTrigger> {
                                         const char** argv) const {
         printSuccessfullyParsed(os, argv, getNumberArgsSuccessfullyParsed());
     }
+
+    /** Print the tokens consumed before parsing stopped, response files
+     * expanded. */
+    void printSuccessfullyParsed(std::ostream& os,
+                                 const ParseResults& results) const;
+
+    /** Usage of the whole parser, rendered once and wrapped at `width`
+     * columns (0 for no wrapping). */
+    const std::string& usageInfo(const std::string& programName,
+                                 size_t width = 0);
+
+    /** Write usageInfo() with one write, wrapped to the terminal if `os` is
+     * one.*/
     void printAllUsageInfo(std::ostream& os, const std::string& programName);
 
     template <template <class T> class FlagType,
@@ -107,8 +339,9 @@ class ArgParser : public ComplexFlag<DoNothingTrigger> {
     template <typename ArgType,
               typename ConverterFunc = Converter<typename ArgType::ValueType>,
               typename ArgValueType = typename ArgType::ValueType>
-    typename std::enable_if<std::is_base_of<ArgBase, ArgType>::value,
-                            Arg<ArgValueType, ConverterFunc>&>::type
+    typename std::enable_if<
+        std::is_base_of<ArgBase, ArgType>::value,
+        typename ArgType::template WithConverter<ConverterFunc>&>::type
     add(const std::string& name, const Policy policy,
         const std::string& description,
         ConverterFunc&& convert = Converter<ArgValueType>()) {
@@ -121,30 +354,43 @@ class ArgParser : public ComplexFlag<DoNothingTrigger> {
         printGroups.emplace_back(*this, name, std::move(description));
         PrintGroup& pg = printGroups.back();
         if (helpFlag) {
-            helpFlag->add<Flag>(
-                name, Policy::OPTIONAL, "",
-                [&pg](const std::string&) { pg.printUsageHelp(std::cout); });
+            // printed by validateArgs() once parsing stopped at --help
+            pg.helpFlag = &helpFlag->add<Flag>(name, Policy::OPTIONAL, "");
         }
         return pg;
     }
 };
 
+inline PrintGroup::PrintGroup(ArgParser& argParser, const std::string& name,
+                              const std::string& description,
+                              bool isDefaultGroup)
+    : argParser(argParser),
+      name(name),
+      description(description),
+      flagsToPrint(argParser.store.allocator<const FlagBase*>()),
+      isDefaultGroup(isDefaultGroup) {}
+
 template <template <class T> class FlagType, typename OnParseTriggerType>
 typename std::enable_if<
     std::is_base_of<FlagBase, FlagType<OnParseTriggerType>>::value,
     FlagType<OnParseTriggerType>&>::type
 PrintGroup::add(const std::string& flag, const Policy policy,
                 const std::string& description, OnParseTriggerType&& trigger) {
+    auto& added =
+        static_cast<ComplexFlag<DoNothingTrigger>&>(argParser).add<FlagType>(
+            flag, policy, description,
+            std::forward<OnParseTriggerType>(trigger));
     if (!isDefaultGroup) {
-        flagsToPrint.emplace_back(flag);
+        // refer to the copy of the name owned by the parser
+        flagsToPrint.emplace_back(argParser.getFlagInsertionOrder().back());
     }
-    return static_cast<ComplexFlag<DoNothingTrigger>&>(argParser).add<FlagType>(
-        flag, policy, description, std::forward<OnParseTriggerType>(trigger));
-}  // namespace AutoArgParse
+    return added;
+}
 
 template <typename ArgType, typename ConverterFunc, typename ArgValueType>
-typename std::enable_if<std::is_base_of<ArgBase, ArgType>::value,
-                        Arg<ArgValueType, ConverterFunc>&>::type
+typename std::enable_if<
+    std::is_base_of<ArgBase, ArgType>::value,
+    typename ArgType::template WithConverter<ConverterFunc>&>::type
 PrintGroup::add(const std::string& name, const Policy policy,
                 const std::string& description, ConverterFunc&& convert) {
     if (!isDefaultGroup) {
@@ -154,16 +400,18 @@ PrintGroup::add(const std::string& name, const Policy policy,
         name, policy, description, std::forward<ConverterFunc>(convert));
 }
 
-ExclusiveFlagGroup<DoNothingTrigger>& PrintGroup::makeExclusiveGroup(Policy p) {
+inline ExclusiveFlagGroup<DoNothingTrigger>& PrintGroup::makeExclusiveGroup(
+    Policy p) {
     return argParser.makeExclusiveGroup(p);
 }
 inline ArgParser::ArgParser(bool addHelpFlag)
     : ComplexFlag(Policy::MANDATORY, "", DoNothingTrigger()),
       printGroups({PrintGroup(*this, "default", "", true)}) {
+    attach(&schema);
     if (addHelpFlag) {
         helpFlag =
-            &add<ComplexFlag>("--help", Policy::OPTIONAL, "Print usage help.",
-                              HelpFlagTrigger(*this));
+            &add<ComplexFlag>("--help", Policy::OPTIONAL, "Print usage help.");
+        helpFlag->requestsHelp = true;
     }
 }
 }  // namespace AutoArgParse
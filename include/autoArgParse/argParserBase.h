@@ -1,29 +1,480 @@
 #ifndef AUTOARGPARSE_ARGPARSERBASE_H_
 #define AUTOARGPARSE_ARGPARSERBASE_H_
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <deque>
+#include <exception>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
+#include "arena.h"
+#include "argHandlers.h"
+#include "conversionPool.h"
+#include "exceptions.h"
+#include "flagIndex.h"
+#include "flagSet.h"
+#include "frozenSchema.h"
 #include "indentedLine.h"
+#include "mappedFile.h"
+#include "parseStats.h"
+#include "stringPool.h"
+#include "stringView.h"
 namespace AutoArgParse {
-typedef std::vector<std::string>::iterator ArgIter;
+// tokens refer to the command line in place, see StringView
+typedef std::vector<StringView>::iterator ArgIter;
 
 enum Policy { MANDATORY, OPTIONAL };
 
+enum ParseFailureReason {
+    MISSING_MANDATORY_FLAG,
+    REPEATED_FLAG,
+    MISSING_MANDATORY_ARG,
+    UNEXPECTED_ARG,
+    MORE_THAN_ONE_EXCLUSIVE_ARG,
+    FAILED_ARG_CONVERSION,
+    INVALID_RESPONSE_FILE,
+    LAZY_FLAG_NOT_BUILT
+};
+
+/**
+ * What a command line token is, worked out for every token before parsing
+ * starts (see ParseResults::classifyTokens()).  A value token names no flag
+ * anywhere in the schema, so no store looks it up again.
+ */
+enum TokenKind : uint8_t {
+    VALUE_TOKEN,
+    // names a flag of some store, not necessarily of the one parsing it
+    FLAG_TOKEN,
+    // a value split off the flag before it, see ArgParser::expandCombinedFlags
+    ATTACHED_VALUE_TOKEN
+};
+
+class ParseToken;
+class ArgBase;
+class FlagBase;
+class ExclusiveGroupBase;
+class FlagStore;
+
+// vectors rather than deques, which allocate even when empty
+typedef std::vector<StringView, ArenaAllocator<StringView>> NameList;
+// flags and exclusive groups in the order they are printed
+typedef std::vector<const FlagBase*, ArenaAllocator<const FlagBase*>> FlagList;
+
+/**
+ * Why parsing stopped, recorded in ParseResults rather than thrown.  Only
+ * what describes the failure is kept, the message is formatted on demand by
+ * ParseResults::errorMessage().
+ */
+struct ParseFailure {
+    ParseFailureReason reason = UNEXPECTED_ARG;
+    // index in ParseResults::tokens of the offending token, the number of
+    // tokens if the command line ended too early
+    size_t tokenIndex = 0;
+    // the parser or flag whose options were expected
+    const FlagStore* store = NULL;
+    // the arg that could not convert its token, the response file that could
+    // not be read or the exclusive flag parsed first
+    StringView name;
+    // why the token could not be converted or the response file read
+    ConversionError explanation;
+    // the group of two exclusive flags given together
+    const NameList* exclusiveFlags = NULL;
+};
+
+/**
+ * The conversion of a mandatory arg's token, put off until the whole command
+ * line has been matched, see ArgParser::convertConcurrently().
+ */
+struct DeferredConversion {
+    const ArgBase* arg;
+    // index in ParseResults::tokens of the token to convert
+    size_t tokenIndex;
+    // number of tokens parsed before the arg, see
+    // ParseResults::getParsedInOrder
+    size_t parsedIndex;
+    bool converted = false;
+    ConversionError error;
+#if AUTOARGPARSE_EXCEPTIONS
+    // set when the converter threw anything but ErrorMessage
+    std::exception_ptr exception;
+#endif
+
+    DeferredConversion(const ArgBase* arg, size_t tokenIndex,
+                       size_t parsedIndex)
+        : arg(arg), tokenIndex(tokenIndex), parsedIndex(parsedIndex) {}
+};
+
+/**
+ * Bytes held by a schema, see ArgParser::schemaMemory().  All but `indexes`
+ * are parts of the arena.
+ */
+struct SchemaMemory {
+    // flag and arg names, each distinct name once
+    size_t names = 0;
+    // descriptions, each distinct description once
+    size_t descriptions = 0;
+    // flag and arg objects, their converters excepted
+    size_t nodes = 0;
+    // converters held by args
+    size_t converters = 0;
+    // the rest of the arena: maps and lists of the stores, alignment padding
+    size_t containers = 0;
+    // outside the arena: flag indexes or frozen tables and the string pool
+    size_t indexes = 0;
+
+    inline size_t total() const {
+        return names + descriptions + nodes + converters + containers +
+               indexes;
+    }
+};
+
+/**
+ * What every token of one ArgParser shares: the arena the schema is allocated
+ * from, its interned strings and the layout of ParseResults.  Tokens are
+ * numbered as they are added and those producing a value (args, exclusive
+ * groups) reserve space for it.
+ */
+class Schema {
+   public:
+    Arena arena;
+    StringPool strings{&arena};
+    // the flag tables of every store, filled by ArgParser::freeze()
+    FrozenSchema frozen;
+    // every flag name of every store, each under the first flag added with
+    // it, see findFlagName().  Moved to store namesStore of frozen by
+    // ArgParser::freeze(), only names added afterwards by LazyFlags are left.
+    FlagIndex<const FlagBase*> flagNames;
+    size_t namesStore = FrozenSchema::npos;
+    // LazyFlags by name, those built included until ArgParser::buildLazyFlags()
+    std::unordered_multimap<StringView, FlagBase*, StringViewHash> lazyFlags;
+    // what was added to the arena for names, descriptions, nodes and
+    // converters, the rest is left to ArgParser::schemaMemory()
+    SchemaMemory memory;
+    size_t numberTokens = 0;
+    size_t valuesSize = 0;
+
+    inline size_t addToken() { return numberTokens++; }
+
+    /** The first flag added named `token` in any store, NULL if there is
+     * none. */
+    inline const FlagBase* findFlagName(StringView token) const {
+        if (namesStore != FrozenSchema::npos) {
+            const FlagBase* found = frozen.find(namesStore, token);
+            if (found) {
+                return found;
+            }
+        }
+        const FlagBase* const* found = flagNames.find(token);
+        return (found) ? *found : NULL;
+    }
+
+    /** Intern `str`, adding the bytes it took in the arena to `counter`. */
+    inline StringView intern(StringView str, size_t& counter) {
+        size_t before = arena.bytesUsed();
+        StringView interned = strings.intern(str);
+        counter += arena.bytesUsed() - before;
+        return interned;
+    }
+
+    /** Count `size` bytes of a node just created as its converter's. */
+    inline void countConverter(size_t size) {
+        memory.nodes -= size;
+        memory.converters += size;
+    }
+
+    /** Reserve space for a value, returns its offset in ParseResults. */
+    inline size_t addValue(size_t size, size_t alignment) {
+        valuesSize = (valuesSize + alignment - 1) / alignment * alignment;
+        size_t offset = valuesSize;
+        valuesSize += size;
+        return offset;
+    }
+};
+
+namespace detail {
+/**
+ * A FlagStore being parsed, see FlagStore::parse().  Nested stores are parsed
+ * in a loop over a stack of these rather than by recursion.
+ */
+struct ParseFrame {
+    const FlagStore* store;
+    // the flag holding the store and the token naming it, NULL for the store
+    // parsing started from
+    const FlagBase* flag;
+    StringView flagToken;
+    // where the slots parsed by the store start in ParseResults::flagBits,
+    // an offset as the stores nested in it may reallocate the bits
+    size_t parsedFlags;
+    int numberParsedMandatoryArgs;
+#if AUTOARGPARSE_STATS
+    std::chrono::steady_clock::time_point start;
+#endif
+};
+
+/**
+ * What ParseResults keeps of a parsed token to forget it later without the
+ * token, whose parser may be gone by then, see ParseResults::clear().
+ */
+struct ParsedToken {
+    size_t id;
+    // destroys the token's value in ParseResults::values, NULL if it has none
+    // or the value needs no destruction
+    void (*destroy)(void*);
+    size_t valueOffset;
+};
+
+template <typename T>
+inline void destroyValue(void* value) {
+    static_cast<T*>(value)->~T();
+}
+}  // namespace detail
+
+/**
+ * The outcome of parsing one command line: which tokens were parsed, the
+ * values of the parsed args and, if parsing stopped early, why.  Parsing only
+ * reads the schema, so any number of ParseResults may be filled at the same
+ * time from one ArgParser (see ArgParser::parseArgs).  Read them through the
+ * tokens, e.g. `flag.parsed(results)` or `arg.get(results)`.  Results may be
+ * reused, clearing them only visits the tokens that were parsed.  They keep
+ * what they need to destroy their values, so they may outlive their parser.
+ */
+class ParseResults {
+    std::vector<unsigned char> parsedTokens;
+    std::vector<std::max_align_t> values;
+    // every token parsed, in order
+    std::vector<const ParseToken*> parsedInOrder;
+    // what to forget of each token in parsedInOrder, see forget()
+    std::vector<detail::ParsedToken> parsedEntries;
+    // conversions left to convertDeferred(), in command line order
+    std::vector<DeferredConversion> deferred;
+    // room for the stores holding the innermost store being parsed (see
+    // FlagStore::parse()), its size is not the number in use so it only grows
+    std::vector<detail::ParseFrame> frames;
+    std::vector<uint64_t> flagBits;
+    // the kind of each token, see classifyTokens()
+    std::vector<TokenKind> tokenKinds;
+    // the flag of the schema first added with the name of each flag token
+    std::vector<const FlagBase*> tokenFlags;
+    friend class FlagStore;
+
+   public:
+    // views of the command line, argv[0] included, response files expanded
+    std::vector<StringView> tokens;
+    // response files the tokens may refer to
+    std::vector<MappedFile> responseFiles;
+    // command line tokens (argv[0] included) consumed before parsing stopped
+    int numberTokensParsed = 0;
+    // set when the command line was rejected, see failure
+    bool failed = false;
+    ParseFailure failure;
+    // set when parsing stopped at the help flag
+    bool helpRequested = false;
+    // when set, mandatory args leave their conversion to convertDeferred()
+    // and lists convert their values on this pool
+    ConversionPool* conversionPool = NULL;
+#if AUTOARGPARSE_EXCEPTIONS
+    // set when a trigger or converter threw anything but ErrorMessage
+    std::exception_ptr error;
+#endif
+    // filled when built with AUTOARGPARSE_STATS=1, see ParseStats
+    ParseStats stats;
+
+    ParseResults() = default;
+    ParseResults(const ParseResults&) = delete;
+    ParseResults& operator=(const ParseResults&) = delete;
+    ParseResults(ParseResults&&) = default;
+    inline ParseResults& operator=(ParseResults&& other) {
+        clear();
+        parsedTokens = std::move(other.parsedTokens);
+        values = std::move(other.values);
+        parsedInOrder = std::move(other.parsedInOrder);
+        parsedEntries = std::move(other.parsedEntries);
+        deferred = std::move(other.deferred);
+        frames = std::move(other.frames);
+        flagBits = std::move(other.flagBits);
+        tokenKinds = std::move(other.tokenKinds);
+        tokenFlags = std::move(other.tokenFlags);
+        tokens = std::move(other.tokens);
+        responseFiles = std::move(other.responseFiles);
+        numberTokensParsed = other.numberTokensParsed;
+        failed = other.failed;
+        failure = std::move(other.failure);
+        helpRequested = other.helpRequested;
+        conversionPool = other.conversionPool;
+#if AUTOARGPARSE_EXCEPTIONS
+        error = std::move(other.error);
+#endif
+        stats = std::move(other.stats);
+        return *this;
+    }
+    inline ~ParseResults() { clear(); }
+
+    /** Whether parsing stopped before the end of the command line. */
+    inline bool stopped() const { return failed || helpRequested; }
+
+    inline bool succeeded() const {
+#if AUTOARGPARSE_EXCEPTIONS
+        if (error) {
+            return false;
+        }
+#endif
+        return !stopped();
+    }
+
+    /** Record that the command line was rejected at `token`, fill in the
+     * rest of the returned failure as the reason requires.*/
+    inline ParseFailure& fail(ParseFailureReason reason, ArgIter token) {
+        failed = true;
+        failure.reason = reason;
+        failure.tokenIndex = token - tokens.begin();
+        return failure;
+    }
+
+    /** Describe the failure, empty unless failed. */
+    std::string errorMessage() const;
+
+    /** Throw the ParseException describing the failure, or rethrow error. */
+    void rethrow() const;
+
+    /** Forget everything parsed, destroying the values of parsed args. */
+    void clear();
+
+    /** Clear and size the results for `schema`. */
+    inline void prepare(const Schema& schema) {
+        clear();
+        fit(schema);
+    }
+
+    /** Size the results for `schema`, which may have grown since prepare()
+     * as long as nothing was parsed yet. */
+    inline void fit(const Schema& schema) {
+        if (parsedTokens.size() != schema.numberTokens) {
+            parsedTokens.resize(schema.numberTokens, false);
+        }
+        size_t numberValues = (schema.valuesSize + sizeof(std::max_align_t) -
+                               1) /
+                              sizeof(std::max_align_t);
+        if (values.size() != numberValues) {
+            values.resize(numberValues);
+        }
+    }
+
+    inline bool parsed(const ParseToken& token) const;
+    inline void markParsed(const ParseToken& token);
+    /** Mark `token` parsed, its value of type T placed at `valueOffset`. */
+    template <typename T>
+    inline void markParsed(const ParseToken& token, size_t valueOffset);
+    inline void addNodeTime(const ParseToken& node, StringView name,
+                            bool subtree, uint64_t nanoseconds);
+
+    /** Forget the tokens after argv[0], so that they can be appended
+     * again. */
+    inline void clearTokens() {
+        if (tokens.size() > 1) {
+            tokens.resize(1);
+        }
+        tokenKinds.clear();
+    }
+
+    /** Record that tokens[index] is a value split off the flag before it,
+     * see ArgParser::expandCombinedFlags(). */
+    inline void markAttachedValue(size_t index) {
+        if (index >= tokenKinds.size()) {
+            tokenKinds.resize(index + 1, VALUE_TOKEN);
+        }
+        tokenKinds[index] = ATTACHED_VALUE_TOKEN;
+    }
+
+    /** Give every token its kind once all were appended.  The flag found is
+     * kept too, stores holding it then take the token without looking it up
+     * again. */
+    inline void classifyTokens(const Schema& schema) {
+        tokenKinds.resize(tokens.size(), VALUE_TOKEN);
+        tokenFlags.resize(tokens.size());
+        AUTOARGPARSE_COUNT(*this, flagProbes, tokens.size());
+        for (size_t i = 0; i < tokens.size(); i++) {
+            if (tokenKinds[i] == ATTACHED_VALUE_TOKEN) {
+                tokenFlags[i] = NULL;
+                continue;
+            }
+            const FlagBase* found = schema.findFlagName(tokens[i]);
+            tokenKinds[i] = (found) ? FLAG_TOKEN : VALUE_TOKEN;
+            tokenFlags[i] = found;
+        }
+    }
+
+    inline TokenKind tokenKind(ArgIter token) const {
+        return tokenKinds[token - tokens.begin()];
+    }
+
+    /** For a flag token, the flag first added with its name. */
+    inline const FlagBase* tokenFlag(ArgIter token) const {
+        return tokenFlags[token - tokens.begin()];
+    }
+
+    /** The first flag token in [first, last), `last` if there is none. */
+    inline ArgIter nextFlagToken(ArgIter first, ArgIter last) const {
+        static_assert(sizeof(TokenKind) == 1, "kinds are searched as bytes");
+        const size_t begin = first - tokens.begin();
+        const void* found = std::memchr(tokenKinds.data() + begin, FLAG_TOKEN,
+                                        last - first);
+        return (found) ? first + (static_cast<const TokenKind*>(found) -
+                                  (tokenKinds.data() + begin))
+                       : last;
+    }
+
+    /** Mark `arg` parsed, leaving the conversion of `token` into a T at
+     * `valueOffset` to convertDeferred().*/
+    template <typename T>
+    inline void defer(const ArgBase& arg, ArgIter token, size_t valueOffset);
+
+    /**
+     * Run the conversions put off by defer() on conversionPool.  If any
+     * failed, the results become those of parsing stopping at the first of
+     * them, as it would have had the arg converted its token while parsing.
+     */
+    void convertDeferred();
+    inline const std::vector<const ParseToken*>& getParsedInOrder() const {
+        return parsedInOrder;
+    }
+
+    /** Destroy the value of a parsed token and mark it unparsed. */
+    inline void forget(const detail::ParsedToken& token) {
+        if (token.destroy) {
+            token.destroy(value(token.valueOffset));
+        }
+        parsedTokens[token.id] = false;
+    }
+
+    inline void* value(size_t offset) {
+        return reinterpret_cast<char*>(values.data()) + offset;
+    }
+    inline const void* value(size_t offset) const {
+        return reinterpret_cast<const char*>(values.data()) + offset;
+    }
+};
+
 // absolute base class for flags and args
 class ParseToken {
+    friend ParseResults;
+
    protected:
     bool _parsed;
     bool _available = true;
+    // position in the schema, see Schema
+    size_t id = 0;
 
    public:
     const Policy policy;  // optional or mandatory
-    const std::string
-        description;  // help info on this parse token (e.g. flag, arg,etc.)
+    // help info on this parse token (e.g. flag, arg,etc.), the characters are
+    // owned by the schema's arena
+    const StringView description;
 
-    ParseToken(const Policy policy, const std::string& description)
+    ParseToken(const Policy policy, StringView description)
         : _parsed(false), policy(policy), description(description) {}
     virtual ~ParseToken() = default;
 
@@ -33,33 +484,175 @@ class ParseToken {
      */
     inline bool parsed() const { return _parsed; }
 
+    /** Whether this token was parsed into `results`. */
+    inline bool parsed(const ParseResults& results) const {
+        return results.parsed(*this);
+    }
+
     inline operator bool() const { return parsed(); }
 
-    inline bool available() { return _available; }
+    inline bool available() const { return _available; }
+
+    /**
+     * Forget the outcome of the last parse so that the token may be parsed
+     * again.  Side effects of triggers and converters are not undone.
+     */
+    virtual inline void reset() {
+        _parsed = false;
+        _available = true;
+    }
+
+    /** Called once the token has been added to `schema`, tokens owning nested
+     * tokens should add them to `schema` too. May be NULL.*/
+    virtual inline void attach(Schema* schema) {
+        if (schema) {
+            id = schema->addToken();
+        }
+    }
+
+    /**
+     * Copy the outcome of a parse from `results` into the token itself, this
+     * is what lets validateArgs() users call parsed() and get() directly.
+     */
+    virtual inline void commit(ParseResults&) { _parsed = true; }
 };
 
+inline bool ParseResults::parsed(const ParseToken& token) const {
+    return token.id < parsedTokens.size() && parsedTokens[token.id];
+}
+
+inline void ParseResults::markParsed(const ParseToken& token) {
+    parsedTokens[token.id] = true;
+    parsedInOrder.push_back(&token);
+    parsedEntries.push_back(detail::ParsedToken{token.id, NULL, 0});
+}
+
+template <typename T>
+inline void ParseResults::markParsed(const ParseToken& token,
+                                     size_t valueOffset) {
+    parsedTokens[token.id] = true;
+    parsedInOrder.push_back(&token);
+    parsedEntries.push_back(detail::ParsedToken{
+        token.id,
+        (std::is_trivially_destructible<T>::value) ? NULL
+                                                   : &detail::destroyValue<T>,
+        valueOffset});
+}
+
+inline void ParseResults::addNodeTime(const ParseToken& node, StringView name,
+                                      bool subtree, uint64_t nanoseconds) {
+    if (node.id >= stats.nodes.size()) {
+        stats.nodes.resize(node.id + 1);
+    }
+    ParseStats::NodeTime& time = stats.nodes[node.id];
+    time.node = &node;
+    time.name = name;
+    time.subtree = subtree;
+    ++time.calls;
+    time.nanoseconds += nanoseconds;
+}
+
+namespace detail {
+/** Adds the time of its scope to a node of ParseResults::stats, see
+ * AUTOARGPARSE_TIME. */
+class NodeTimer {
+    ParseResults& results;
+    const ParseToken& node;
+    StringView name;
+    bool subtree;
+    std::chrono::steady_clock::time_point start;
+
+   public:
+    NodeTimer(ParseResults& results, const ParseToken& node, StringView name,
+              bool subtree)
+        : results(results),
+          node(node),
+          name(name),
+          subtree(subtree),
+          start(std::chrono::steady_clock::now()) {}
+    ~NodeTimer() {
+        results.addNodeTime(node, name, subtree, nanosecondsSince(start));
+    }
+};
+}  // namespace detail
+
+inline void ParseResults::clear() {
+    for (const detail::ParsedToken& token : parsedEntries) {
+        forget(token);
+    }
+    parsedInOrder.clear();
+    parsedEntries.clear();
+    deferred.clear();
+    flagBits.clear();
+    tokenKinds.clear();
+    tokenFlags.clear();
+    tokens.clear();
+    responseFiles.clear();
+    numberTokensParsed = 0;
+    if (failed) {
+        failed = false;
+        failure = ParseFailure();
+    }
+    helpRequested = false;
+#if AUTOARGPARSE_EXCEPTIONS
+    error = nullptr;
+#endif
+    stats.clear();
+}
+
 /**Forward declaration of FlagStore such that it may be a friend */
 class FlagStore;
 class ArgBase : public ParseToken {
     friend FlagStore;
 
    protected:
-    virtual void parse(ArgIter& first, ArgIter& last) = 0;
+    /** Returns false if parsing must stop, see ParseResults::stopped(). */
+    virtual bool parse(ParseResults& results, ArgIter& first,
+                       ArgIter& last) const = 0;
 
    public:
-    const std::string name;  // name/description of the arg, not the argitself
-    ArgBase(const std::string& name, const Policy policy,
-            const std::string& description)
+    const StringView name;  // name/description of the arg, not the argitself
+    ArgBase(StringView name, const Policy policy, StringView description)
         : ParseToken(policy, description), name(name) {}
     virtual ~ArgBase() = default;
+
+    /** Whether this arg takes a run of values rather than a single one. */
+    virtual inline bool collectsValues() const { return false; }
+
+    /** Convert a token left by ParseResults::defer() into `results`,
+     * returns false and sets `error` if it cannot be.  Called concurrently
+     * for different args.*/
+    virtual inline bool convertToken(ParseResults&, StringView,
+                                     ConversionError&) const {
+        return true;
+    }
 };
 
+template <typename T>
+inline void ParseResults::defer(const ArgBase& arg, ArgIter token,
+                                size_t valueOffset) {
+    deferred.emplace_back(&arg, token - tokens.begin(), parsedInOrder.size());
+    markParsed<T>(arg, valueOffset);
+}
+
 /**
  * non templated base of flag.
  */
 class FlagBase : public ParseToken {
    public:
-    virtual void parse(ArgIter& first, ArgIter& last) = 0;
+    // the name the flag was added under, empty for exclusive groups
+    StringView name;
+    // position among the flags and groups of the store holding it, see
+    // FlagStore and FlagSet
+    size_t slot = 0;
+    // the exclusive group this flag belongs to, if any
+    ExclusiveGroupBase* exclusiveGroup = NULL;
+    // parsing stops once this flag is parsed, as for --help
+    bool requestsHelp = false;
+
+    /** Returns false if parsing must stop, see ParseResults::stopped(). */
+    virtual bool parse(ParseResults& results, ArgIter& first,
+                       ArgIter& last) const = 0;
     using ParseToken::ParseToken;
     inline virtual void printUsageHelp(std::ostream&, IndentedLine&) const {}
     inline virtual void printUsageSummary(std::ostream&) const {}
@@ -68,17 +661,36 @@ class FlagBase : public ParseToken {
         IndentedLine lineIndent(0);
         printUsageHelp(os, lineIndent);
     }
-    typedef std::unique_ptr<FlagBase> FlagPtr;
-    typedef std::unordered_map<std::string, FlagPtr> FlagMap;
-    typedef std::vector<std::unique_ptr<ArgBase>> ArgVector;
-    virtual inline bool isExclusiveGroup() { return false; }
+    typedef std::unique_ptr<FlagBase, NodeDeleter> FlagPtr;
+    typedef std::unique_ptr<ArgBase, NodeDeleter> ArgPtr;
+    typedef std::unordered_map<
+        StringView, FlagPtr, StringViewHash, std::equal_to<StringView>,
+        ArenaAllocator<std::pair<const StringView, FlagPtr>>>
+        FlagMap;
+    typedef std::vector<ArgPtr, ArenaAllocator<ArgPtr>> ArgVector;
+    virtual inline bool isExclusiveGroup() const { return false; }
 
-    virtual const std::deque<std::string>& getFlagInsertionOrder() const {
-        abort();
-    }
+    virtual const FlagList& getFlagInsertionOrder() const { abort(); }
+
+    /** False for a LazyFlag whose flags and args were not added yet. */
+    virtual inline bool built() const { return true; }
+
+    /** Add the flags and args of a LazyFlag, see ArgParser::buildLazyFlags().
+     */
+    virtual inline void build() {}
+
+    /** The flags and args nested under this flag, NULL if it has none.
+     * Parsing such a flag parses its store rather than calling parse(). */
+    virtual FlagStore* getNestedStore() { return NULL; }
+    virtual const FlagStore* getNestedStore() const { return NULL; }
+
+    /** Called once the nested store parsed its tokens, `flag` is the token
+     * naming this flag. */
+    virtual void nestedParsed(StringView) const {}
 };
-typedef std::unique_ptr<FlagBase> FlagPtr;
-typedef std::unordered_map<std::string, FlagPtr> FlagMap;
-typedef std::vector<std::unique_ptr<ArgBase>> ArgVector;
+typedef FlagBase::FlagPtr FlagPtr;
+typedef FlagBase::ArgPtr ArgPtr;
+typedef FlagBase::FlagMap FlagMap;
+typedef FlagBase::ArgVector ArgVector;
 }  // namespace AutoArgParse
 #endif /* AUTOARGPARSE_ARGPARSERBASE_H_ */
@@ -1,45 +1,430 @@
 
 #ifndef AUTOARGPARSE_ARGS_H_
 #define AUTOARGPARSE_ARGS_H_
+#include <exception>
+#include <memory>
+#include <new>
+#include <vector>
 #include "argParserBase.h"
 namespace AutoArgParse {
-
-// forward decls of functions that throw exceptions, cannot include
-// parseException.h in this file due to circular dependencies
-void throwFailedArgConversionException(const std::string& name,
-                                       const std::string& additionalExpl);
+namespace detail {
+/** `arg` could not take `token`: parsing fails if the arg is mandatory,
+ * otherwise the token is left to the flags and args that follow.*/
+inline bool rejectToken(ParseResults& results, const ArgBase& arg,
+                        ArgIter token, ConversionError&& error) {
+    if (arg.policy == Policy::MANDATORY) {
+        ParseFailure& failure = results.fail(FAILED_ARG_CONVERSION, token);
+        failure.name = arg.name;
+        failure.explanation = std::move(error);
+        return false;
+    }
+    AUTOARGPARSE_COUNT(results, rejectedOptionalArgs, 1);
+    return true;
+}
+}  // namespace detail
 
 template <typename T, typename ConverterFunc = FakeDoNothingConverter<T>>
 class Arg : public ArgBase {
    public:
     typedef T ValueType;
+    // the type created by add<Arg<T>>() for a given converter
+    template <typename OtherConverterFunc>
+    using WithConverter = Arg<T, OtherConverterFunc>;
 
    private:
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "over aligned argument types are not supported");
     T parsedValue;
-    ConverterFunc convert;
+    // parsing does not modify the schema, but converters may have non const
+    // call operators
+    mutable ConverterFunc convert;
+    // where the value is kept in ParseResults
+    size_t valueOffset = 0;
+    // whether the converter rejects tokens by throwing
+    typedef detail::ConverterThrows<ConverterFunc, StringView> Throws;
 
    protected:
-    virtual inline void parse(ArgIter& first, ArgIter&) {
-        _parsed = false;
-        try {
-            parsedValue = std::move(convert(*first));
+    virtual inline bool parse(ParseResults& results, ArgIter& first,
+                              ArgIter&) const {
+        ConversionError error;
+        if (!detail::validateToken(convert, *first, error)) {
+            return detail::rejectToken(results, *this, first, std::move(error));
+        }
+        // an optional arg turning down its token changes what follows, only
+        // mandatory args can convert once the command line has been matched
+        if (results.conversionPool && this->policy == Policy::MANDATORY) {
+            results.defer<T>(*this, first, valueOffset);
             ++first;
-            _parsed = true;
-        } catch (ErrorMessage& e) {
-            if (this->policy == Policy::MANDATORY) {
-                throwFailedArgConversionException(this->name, e.message);
-            } else {
-                return;
-            }
+            return true;
+        }
+        bool converted;
+        {
+            AUTOARGPARSE_TIME(results, *this, name, false);
+            converted = convertToken(results, *first, error);
+        }
+        AUTOARGPARSE_COUNT(results, conversions, 1);
+        if (!converted) {
+            AUTOARGPARSE_COUNT(results, exceptionsThrown, Throws::value);
+            return detail::rejectToken(results, *this, first, std::move(error));
+        }
+        ++first;
+        results.markParsed<T>(*this, valueOffset);
+        return true;
+    }
+
+    virtual inline bool convertToken(ParseResults& results, StringView token,
+                                     ConversionError& error) const {
+        auto converted = tryConvert(convert, token);
+        if (!converted) {
+            error = std::move(converted.error);
+            return false;
         }
+        new (results.value(valueOffset)) T(std::move(converted.value));
+        return true;
     }
 
    public:
-    Arg(const std::string& name, const Policy policy,
-        const std::string& description, ConverterFunc convert)
+    Arg(StringView name, const Policy policy, StringView description,
+        ConverterFunc convert)
         : ArgBase(name, policy, description), convert(std::move(convert)) {}
 
     T& get() { return parsedValue; }
+
+    /** The value parsed into `results`, only valid if parsed(results). */
+    inline T& get(ParseResults& results) const {
+        return *static_cast<T*>(results.value(valueOffset));
+    }
+    inline const T& get(const ParseResults& results) const {
+        return *static_cast<const T*>(results.value(valueOffset));
+    }
+
+    virtual inline void attach(Schema* schema) {
+        ArgBase::attach(schema);
+        if (schema) {
+            valueOffset = schema->addValue(sizeof(T), alignof(T));
+        }
+    }
+
+    virtual inline void commit(ParseResults& results) {
+        ArgBase::commit(results);
+        parsedValue = std::move(get(results));
+    }
+
+    virtual inline void reset() {
+        if (_parsed) {
+            parsedValue = T();
+        }
+        ArgBase::reset();
+    }
+};
+
+/**
+ * An Arg converting its token on the first get() rather than while parsing,
+ * so that e.g. LazyArg<std::ifstream> does not open files the program never
+ * reads.  Parsing only runs the validator of converters made by validated(),
+ * every token is accepted otherwise.  The outcome of the conversion is kept:
+ * get() throws ErrorMessage if it failed, tryGet() reports it instead.  The
+ * token is referred to, not copied, so argv and the results parsed into
+ * must outlive the first get().
+ */
+template <typename T, typename ConverterFunc = FakeDoNothingConverter<T>>
+class LazyArg : public ArgBase {
+   public:
+    typedef T ValueType;
+    template <typename OtherConverterFunc>
+    using WithConverter = LazyArg<T, OtherConverterFunc>;
+
+   private:
+    typedef ConversionResult<T> Result;
+
+    // the token and, once converted, the outcome; the outcome is only
+    // constructed by the conversion, parsing never builds a T
+    struct Slot {
+        StringView token;
+        bool converted = false;
+        typename std::aligned_storage<sizeof(Result), alignof(Result)>::type
+            storage;
+
+        Slot() = default;
+        explicit Slot(StringView token) : token(token) {}
+        Slot(Slot&& other) : token(other.token) { take(other); }
+        inline Slot& operator=(Slot&& other) {
+            if (this != &other) {
+                clear();
+                token = other.token;
+                take(other);
+            }
+            return *this;
+        }
+        ~Slot() { clear(); }
+
+        inline Result& result() { return *reinterpret_cast<Result*>(&storage); }
+        inline void set(Result&& converted) {
+            new (&storage) Result(std::move(converted));
+            this->converted = true;
+        }
+        inline void take(Slot& other) {
+            if (other.converted) {
+                set(std::move(other.result()));
+            }
+        }
+        inline void clear() {
+            if (converted) {
+                result().~Result();
+                converted = false;
+            }
+        }
+    };
+    static_assert(alignof(Slot) <= alignof(std::max_align_t),
+                  "over aligned argument types are not supported");
+    Slot parsedSlot;
+    // parsing does not modify the schema, but converters may have non const
+    // call operators
+    mutable ConverterFunc convert;
+    // where the slot is kept in ParseResults
+    size_t valueOffset = 0;
+
+    inline Slot& slot(ParseResults& results) const {
+        return *static_cast<Slot*>(results.value(valueOffset));
+    }
+
+    inline Result& resolve(Slot& slot) const {
+        if (!slot.converted) {
+            auto converted = tryConvert(convert, slot.token);
+            slot.set((converted) ? Result(T(std::move(converted.value)))
+                                 : Result(std::move(converted.error)));
+        }
+        return slot.result();
+    }
+
+    inline T& value(Slot& slot) const {
+        Result& result = resolve(slot);
+        if (!result) {
+            AUTOARGPARSE_THROW(ErrorMessage("Could not parse argument: " +
+                                            name.str() + "\n" +
+                                            result.error.message()));
+        }
+        return result.value;
+    }
+
+   protected:
+    virtual inline bool parse(ParseResults& results, ArgIter& first,
+                              ArgIter&) const {
+        ConversionError error;
+        if (!detail::validateToken(convert, *first, error)) {
+            return detail::rejectToken(results, *this, first, std::move(error));
+        }
+        new (results.value(valueOffset)) Slot(*first);
+        ++first;
+        results.markParsed<Slot>(*this, valueOffset);
+        return true;
+    }
+
+   public:
+    LazyArg(StringView name, const Policy policy, StringView description,
+            ConverterFunc convert)
+        : ArgBase(name, policy, description), convert(std::move(convert)) {}
+
+    /** The token as given on the command line. */
+    inline StringView token() const { return parsedSlot.token; }
+
+    /** Convert on first call, throws ErrorMessage if the conversion failed. */
+    inline T& get() { return value(parsedSlot); }
+
+    /** Convert on first call, the value or why it could not be converted. */
+    inline Result& tryGet() { return resolve(parsedSlot); }
+
+    /** As get() and tryGet(), for a value parsed into `results`, only valid if
+     * parsed(results).*/
+    inline T& get(ParseResults& results) const { return value(slot(results)); }
+    inline Result& tryGet(ParseResults& results) const {
+        return resolve(slot(results));
+    }
+
+    virtual inline void attach(Schema* schema) {
+        ArgBase::attach(schema);
+        if (schema) {
+            valueOffset = schema->addValue(sizeof(Slot), alignof(Slot));
+        }
+    }
+
+    virtual inline void commit(ParseResults& results) {
+        ArgBase::commit(results);
+        parsedSlot = std::move(slot(results));
+    }
+
+    virtual inline void reset() {
+        if (_parsed) {
+            parsedSlot.clear();
+        }
+        ArgBase::reset();
+    }
+};
+
+/**
+ * Collects a run of consecutive values, e.g. the sources of "copy SRC...
+ * DST".  The run ends at the first flag, at the first value that cannot be
+ * converted or where just enough values remain for the mandatory args added
+ * after this one.  Mandatory lists need at least one value.  Values are
+ * stored contiguously, space for the whole run is reserved up front.
+ */
+template <typename T, typename ConverterFunc = FakeDoNothingConverter<T>>
+class ArgList : public ArgBase {
+   public:
+    // type of each element, converted one at a time
+    typedef T ValueType;
+    template <typename OtherConverterFunc>
+    using WithConverter = ArgList<T, OtherConverterFunc>;
+    typedef std::vector<T> Values;
+
+   private:
+    Values parsedValues;
+    // parsing does not modify the schema, but converters may have non const
+    // call operators
+    mutable ConverterFunc convert;
+    // where the values are kept in ParseResults
+    size_t valueOffset = 0;
+    // whether the converter rejects tokens by throwing
+    typedef detail::ConverterThrows<ConverterFunc, StringView> Throws;
+
+    typedef ConversionResult<T> Result;
+    typedef typename std::aligned_storage<sizeof(Result), alignof(Result)>::type
+        ResultStorage;
+
+    /**
+     * Convert the whole run on `pool`, then keep values up to the first
+     * token that could not be converted, as parsing them one at a time
+     * would.  Tokens after that one are converted for nothing.
+     */
+    inline bool parseConcurrently(ParseResults& results, ArgIter& first,
+                                  ArgIter& last, ConversionPool& pool) const {
+        const size_t size = std::distance(first, last);
+        std::unique_ptr<ResultStorage[]> storage(new ResultStorage[size]);
+        Result* converted = reinterpret_cast<Result*>(storage.get());
+#if AUTOARGPARSE_EXCEPTIONS
+        std::vector<std::exception_ptr> exceptions(size);
+#endif
+        const ArgIter begin = first;
+        pool.run(size, [&](size_t i) {
+#if AUTOARGPARSE_EXCEPTIONS
+            try {
+                new (&converted[i]) Result(tryConvert(convert, begin[i]));
+            } catch (...) {
+                exceptions[i] = std::current_exception();
+            }
+#else
+            new (&converted[i]) Result(tryConvert(convert, begin[i]));
+#endif
+        });
+        Values values;
+        values.reserve(size);
+        bool carryOn = true;
+        size_t i = 0;
+#if AUTOARGPARSE_EXCEPTIONS
+        std::exception_ptr exception;
+#endif
+        for (; i < size; i++) {
+#if AUTOARGPARSE_EXCEPTIONS
+            if (exceptions[i]) {
+                exception = exceptions[i];
+                break;
+            }
+#endif
+            if (!converted[i]) {
+                if (values.empty()) {
+                    carryOn = detail::rejectToken(
+                        results, *this, first, std::move(converted[i].error));
+                }
+                break;
+            }
+            values.push_back(std::move(converted[i].value));
+            ++first;
+        }
+        for (size_t j = 0; j < size; j++) {
+#if AUTOARGPARSE_EXCEPTIONS
+            if (exceptions[j]) {
+                continue;
+            }
+#endif
+            converted[j].~Result();
+        }
+#if AUTOARGPARSE_EXCEPTIONS
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+#endif
+        if (values.empty()) {
+            return carryOn;
+        }
+        new (results.value(valueOffset)) Values(std::move(values));
+        results.markParsed<Values>(*this, valueOffset);
+        return true;
+    }
+
+   protected:
+    /** `last` is where the run of values ends, see FlagStore.*/
+    virtual inline bool parse(ParseResults& results, ArgIter& first,
+                              ArgIter& last) const {
+        AUTOARGPARSE_TIME(results, *this, name, false);
+        if (results.conversionPool && std::distance(first, last) > 1) {
+            AUTOARGPARSE_COUNT(results, conversions,
+                               std::distance(first, last));
+            return parseConcurrently(results, first, last,
+                                     *results.conversionPool);
+        }
+        Values values;
+        values.reserve(std::distance(first, last));
+        for (; first != last; ++first) {
+            auto converted = tryConvert(convert, *first);
+            AUTOARGPARSE_COUNT(results, conversions, 1);
+            if (!converted) {
+                AUTOARGPARSE_COUNT(results, exceptionsThrown, Throws::value);
+                if (!values.empty()) {
+                    break;
+                }
+                return detail::rejectToken(results, *this, first,
+                                           std::move(converted.error));
+            }
+            values.push_back(std::move(converted.value));
+        }
+        new (results.value(valueOffset)) Values(std::move(values));
+        results.markParsed<Values>(*this, valueOffset);
+        return true;
+    }
+
+   public:
+    ArgList(StringView name, const Policy policy, StringView description,
+            ConverterFunc convert)
+        : ArgBase(name, policy, description), convert(std::move(convert)) {}
+
+    Values& get() { return parsedValues; }
+
+    /** The values parsed into `results`, only valid if parsed(results). */
+    inline Values& get(ParseResults& results) const {
+        return *static_cast<Values*>(results.value(valueOffset));
+    }
+    inline const Values& get(const ParseResults& results) const {
+        return *static_cast<const Values*>(results.value(valueOffset));
+    }
+
+    virtual inline bool collectsValues() const { return true; }
+
+    virtual inline void attach(Schema* schema) {
+        ArgBase::attach(schema);
+        if (schema) {
+            valueOffset = schema->addValue(sizeof(Values), alignof(Values));
+        }
+    }
+
+    virtual inline void commit(ParseResults& results) {
+        ArgBase::commit(results);
+        parsedValues = std::move(get(results));
+    }
+
+    virtual inline void reset() {
+        parsedValues.clear();
+        ArgBase::reset();
+    }
 };
 }  // namespace AutoArgParse
 
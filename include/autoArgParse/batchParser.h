@@ -0,0 +1,55 @@
+#ifndef AUTOARGPARSE_BATCHPARSER_H_
+#define AUTOARGPARSE_BATCHPARSER_H_
+#include <vector>
+#include "argParser.h"
+#include "workerPool.h"
+namespace AutoArgParse {
+
+/** One command line of a batch, as given to main(). */
+struct CommandLine {
+    int argc;
+    const char** argv;
+};
+
+/**
+ * Parses batches of command lines against one ArgParser on a fixed pool of
+ * threads, the calling thread included.  A batch is cut into chunks that the
+ * threads claim through an atomic counter, so they only synchronise when a
+ * batch starts and when it ends.  The parser must not be modified while a
+ * batch is being parsed, and its triggers and converters are called from
+ * several threads at once.  Its LazyFlags must have been built.
+ */
+class BatchParser {
+    const ArgParser& argParser;
+    detail::WorkerPool pool;
+
+   public:
+    /** Zero threads means one per hardware thread. */
+    explicit BatchParser(const ArgParser& argParser, unsigned numberThreads = 0)
+        : argParser(argParser), pool(numberThreads) {
+        if (argParser.hasLazyFlagsToBuild()) {
+            AUTOARGPARSE_THROW(std::logic_error(
+                "Lazy flags are not built by parseArgs(), call "
+                "ArgParser::buildLazyFlags() before parsing batches."));
+        }
+    }
+
+    inline size_t numberThreads() const { return pool.numberThreads(); }
+
+    /**
+     * Parse every command line of `batch`, the outcome of batch[i] is written
+     * to results[i].  Pass the same results again to reuse their memory.
+     */
+    inline void parse(const std::vector<CommandLine>& batch,
+                      std::vector<ParseResults>& results) {
+        results.resize(batch.size());
+        // several chunks per thread balance uneven command lines
+        pool.runIndexed(batch.size(), batch.size() / (numberThreads() * 8),
+                        [&](size_t i) {
+                            argParser.parseArgs(batch[i].argc, batch[i].argv,
+                                                results[i]);
+                        });
+    }
+};
+}  // namespace AutoArgParse
+#endif /* AUTOARGPARSE_BATCHPARSER_H_ */
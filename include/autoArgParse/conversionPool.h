@@ -0,0 +1,44 @@
+#ifndef AUTOARGPARSE_CONVERSIONPOOL_H_
+#define AUTOARGPARSE_CONVERSIONPOOL_H_
+#include <functional>
+#include <mutex>
+#include "workerPool.h"
+namespace AutoArgParse {
+
+/**
+ * A fixed pool of threads, the calling thread included, running converters
+ * once a command line has been matched (see
+ * ArgParser::convertConcurrently()).  Conversions worth running here, such as
+ * opening files, take far longer than claiming them, so they are claimed one
+ * at a time through an atomic counter.  The pool runs one task at a time:
+ * callers finding it busy, e.g. the threads of a BatchParser, run theirs on
+ * their own thread instead of waiting.
+ */
+class ConversionPool {
+    detail::WorkerPool pool;
+    // held by the thread whose task the pool is running
+    std::mutex owner;
+
+   public:
+    /** Zero threads means one per hardware thread. */
+    explicit ConversionPool(unsigned numberThreads = 0) : pool(numberThreads) {}
+
+    inline size_t numberThreads() const { return pool.numberThreads(); }
+
+    /**
+     * Call task(i) for every i < size, in no particular order, and return
+     * once all calls have returned.  `task` must not throw.
+     */
+    inline void run(size_t size, const std::function<void(size_t)>& task) {
+        std::unique_lock<std::mutex> running(owner, std::try_to_lock);
+        if (!running || numberThreads() == 1 || size < 2) {
+            for (size_t i = 0; i < size; i++) {
+                task(i);
+            }
+            return;
+        }
+        pool.runIndexed(size, 1, task);
+    }
+};
+}  // namespace AutoArgParse
+#endif /* AUTOARGPARSE_CONVERSIONPOOL_H_ */
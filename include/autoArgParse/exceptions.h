@@ -0,0 +1,30 @@
+#ifndef AUTOARGPARSE_EXCEPTIONS_H_
+#define AUTOARGPARSE_EXCEPTIONS_H_
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+
+/**
+ * Parsing itself never throws (see ArgParser::tryValidateArgs()), so the
+ * library builds with exceptions disabled.  What would still be thrown then,
+ * e.g. by validateArgs(false) or a converter's call operator, is printed to
+ * std::cerr and aborts instead.
+ */
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define AUTOARGPARSE_EXCEPTIONS 1
+#define AUTOARGPARSE_THROW(exception) throw exception
+#else
+#define AUTOARGPARSE_EXCEPTIONS 0
+#define AUTOARGPARSE_THROW(exception) \
+    ::AutoArgParse::detail::abortWith(exception)
+#endif
+
+namespace AutoArgParse {
+namespace detail {
+[[noreturn]] inline void abortWith(const std::exception& exception) {
+    std::cerr << exception.what() << std::endl;
+    abort();
+}
+}  // namespace detail
+}  // namespace AutoArgParse
+#endif /* AUTOARGPARSE_EXCEPTIONS_H_ */
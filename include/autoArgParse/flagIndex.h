@@ -0,0 +1,112 @@
+#ifndef AUTOARGPARSE_FLAGINDEX_H_
+#define AUTOARGPARSE_FLAGINDEX_H_
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "stringView.h"
+namespace AutoArgParse {
+
+/**
+ * Finds the flag named by a command line token.  Every token that is not a
+ * flag goes through here before it is offered to the args, so rejecting
+ * values quickly matters as much as finding flags.  Tokens longer than every
+ * name, or starting with a character no name starts with (most values, when
+ * flags start with '-'), are rejected without being hashed.  Other tokens
+ * are hashed once and looked up in an open addressing table, comparing
+ * hashes before characters.
+ */
+template <typename Value>
+class FlagIndex {
+    struct Entry {
+        StringView name;
+        Value value;
+        size_t hash;
+    };
+    std::vector<Entry> entries;
+    // index + 1 into entries of each slot, 0 if empty; at most half full
+    std::vector<uint32_t> slots;
+    uint64_t firstCharacters[4] = {0, 0, 0, 0};
+    bool hasEmptyName = false;
+    size_t maxLength = 0;
+
+    inline bool isCandidate(StringView token) const {
+        if (token.size() > maxLength) {
+            return false;
+        }
+        if (token.empty()) {
+            return hasEmptyName;
+        }
+        unsigned char c = static_cast<unsigned char>(token[0]);
+        return (firstCharacters[c / 64] >> (c % 64)) & 1;
+    }
+
+    inline void insertSlot(size_t index) {
+        size_t mask = slots.size() - 1;
+        size_t slot = entries[index].hash & mask;
+        while (slots[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = static_cast<uint32_t>(index + 1);
+    }
+
+   public:
+    inline size_t size() const { return entries.size(); }
+
+    /** Length of the longest name. */
+    inline size_t maxNameLength() const { return maxLength; }
+
+    /** Add a name not in the index yet, `name` must outlive the index. */
+    inline void insert(StringView name, Value value) {
+        entries.push_back({name, value, StringViewHash()(name)});
+        maxLength = std::max(maxLength, name.size());
+        if (name.empty()) {
+            hasEmptyName = true;
+        } else {
+            unsigned char c = static_cast<unsigned char>(name[0]);
+            firstCharacters[c / 64] |= uint64_t(1) << (c % 64);
+        }
+        if (entries.size() * 2 <= slots.size()) {
+            insertSlot(entries.size() - 1);
+            return;
+        }
+        slots.assign(std::max<size_t>(8, slots.size() * 2), 0);
+        for (size_t i = 0; i < entries.size(); i++) {
+            insertSlot(i);
+        }
+    }
+
+    /** The value of the name equal to `token`, NULL if there is none. */
+    inline const Value* find(StringView token) const {
+        if (!isCandidate(token)) {
+            return NULL;
+        }
+        const size_t hash = StringViewHash()(token);
+        const size_t mask = slots.size() - 1;
+        for (size_t slot = hash & mask; slots[slot] != 0;
+             slot = (slot + 1) & mask) {
+            const Entry& entry = entries[slots[slot] - 1];
+            if (entry.hash == hash && entry.name == token) {
+                return &entry.value;
+            }
+        }
+        return NULL;
+    }
+
+    /** Call f(name, value) for every name, in the order they were added. */
+    template <typename F>
+    inline void forEach(F f) const {
+        for (const Entry& entry : entries) {
+            f(entry.name, entry.value);
+        }
+    }
+
+    inline void clear() { *this = FlagIndex(); }
+
+    /** Heap memory held by the index. */
+    inline size_t bytesUsed() const {
+        return entries.capacity() * sizeof(Entry) +
+               slots.capacity() * sizeof(uint32_t);
+    }
+};
+}  // namespace AutoArgParse
+#endif /* AUTOARGPARSE_FLAGINDEX_H_ */
@@ -0,0 +1,79 @@
+#ifndef AUTOARGPARSE_FLAGSET_H_
+#define AUTOARGPARSE_FLAGSET_H_
+#include <cstdint>
+#include <vector>
+namespace AutoArgParse {
+
+/**
+ * A set of flag slots, one bit per slot (see FlagStore).  Sets are compared
+ * with the flags parsed so far a word at a time, `bits` then points to
+ * numberWords(slots) words such as those FlagStore::parse() keeps in
+ * ParseResults.
+ */
+class FlagSet {
+    std::vector<uint64_t> words;
+
+    static inline size_t lowestBit(uint64_t word) {
+        size_t i = 0;
+        while (!((word >> i) & 1)) {
+            ++i;
+        }
+        return i;
+    }
+
+   public:
+    static const size_t npos = static_cast<size_t>(-1);
+
+    static inline size_t numberWords(size_t numberSlots) {
+        return (numberSlots + 63) / 64;
+    }
+    static inline bool contains(const uint64_t* bits, size_t slot) {
+        return (bits[slot / 64] >> (slot % 64)) & 1;
+    }
+    static inline void insert(uint64_t* bits, size_t slot) {
+        bits[slot / 64] |= uint64_t(1) << (slot % 64);
+    }
+
+    inline bool contains(size_t slot) const {
+        return slot / 64 < words.size() && contains(words.data(), slot);
+    }
+    inline void insert(size_t slot) {
+        if (slot / 64 >= words.size()) {
+            words.resize(slot / 64 + 1, 0);
+        }
+        insert(words.data(), slot);
+    }
+    inline void erase(size_t slot) {
+        if (slot / 64 < words.size()) {
+            words[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+        }
+    }
+
+    inline size_t bytesUsed() const {
+        return words.capacity() * sizeof(uint64_t);
+    }
+
+    /** The lowest slot both in this set and in `bits`, npos if none. */
+    inline size_t firstIn(const uint64_t* bits) const {
+        for (size_t i = 0; i < words.size(); i++) {
+            uint64_t shared = words[i] & bits[i];
+            if (shared != 0) {
+                return i * 64 + lowestBit(shared);
+            }
+        }
+        return npos;
+    }
+
+    /** The lowest slot in this set but not in `bits`, npos if none. */
+    inline size_t firstNotIn(const uint64_t* bits) const {
+        for (size_t i = 0; i < words.size(); i++) {
+            uint64_t missing = words[i] & ~bits[i];
+            if (missing != 0) {
+                return i * 64 + lowestBit(missing);
+            }
+        }
+        return npos;
+    }
+};
+}  // namespace AutoArgParse
+#endif /* AUTOARGPARSE_FLAGSET_H_ */
@@ -3,9 +3,10 @@
 #define AUTOARGPARSE_FLAGS_H_
 #include <algorithm>
 #include <cstring>
-#include <deque>
+#include <forward_list>
 #include <iostream>
 #include <memory>
+#include <new>
 #include <stdexcept>
 #include <string>
 #include <unordered_map>
@@ -15,57 +16,139 @@
 #include "argParserBase.h"
 
 namespace AutoArgParse {
+namespace detail {
+/** Bytes an arg takes to hold a ConverterFunc, a reference when the
+ * converter was passed as an lvalue. */
+template <typename ConverterFunc>
+constexpr size_t storedSize() {
+    return (std::is_reference<ConverterFunc>::value) ? sizeof(void*)
+                                                     : sizeof(ConverterFunc);
+}
+}  // namespace detail
+
 struct DoNothingTrigger {
-    void operator()(const std::string&) {}
+    void operator()(StringView) const {}
 };
 
-// some constants
-static const char* alphanumericSymbols =
-    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz1234567890";
-static const size_t alphanumericSymbolsLength = strlen(alphanumericSymbols);
-static const int RANDOM_STRING_LENGTH = 10;
-inline std::string generateRandomString(size_t length) {
-    auto generator = [&]() {
-        return alphanumericSymbols[rand() % alphanumericSymbolsLength];
-    };
-    std::string result;
-    result.reserve(length);
-    std::generate_n(back_inserter(result), length, generator);
-    return result;
-}
-static const std::string RANDOM_STRING =
-    generateRandomString(RANDOM_STRING_LENGTH);
-
 /**
  * Represents a simple flag, does not have any nested flags or arguments.
  */
 template <typename OnParseTrigger>
 class Flag : public FlagBase {
-    OnParseTrigger parsedTrigger;
+    // parsing does not modify the schema, but triggers may have non const
+    // call operators
+    mutable OnParseTrigger parsedTrigger;
 
    protected:
-    inline void triggerParseSuccess(const std::string& flag) {
+    inline void triggerParseSuccess(StringView flag) const {
         parsedTrigger(flag);
     }
-    inline virtual void parse(ArgIter& first, ArgIter&) {
-        _parsed = true;
+    inline virtual bool parse(ParseResults&, ArgIter& first, ArgIter&) const {
         triggerParseSuccess(first[-1]);
+        return true;
         // we know that first always points to the element just after the most
         // recently parsed flag
     }
 
    public:
-    Flag(const Policy policy, const std::string& description,
+    Flag(const Policy policy, StringView description,
          OnParseTrigger&& trigger)
         : FlagBase(policy, description),
           parsedTrigger(std::forward<OnParseTrigger>(trigger)) {}
     virtual ~Flag() = default;
 };
 
-void printUsageHelp(const std::deque<std::string>& flagInsertionOrder,
-                    const FlagMap& flags, std::ostream& os,
+void printUsageHelp(const FlagList& flagInsertionOrder, std::ostream& os,
                     IndentedLine& lineIndent);
 
+/**
+ * Non templated part of ExclusiveFlagGroup: at most one of its members may
+ * be parsed.  Members are flags of the store holding the group, the store
+ * checks exclusivity by comparing the slots of the members with those
+ * parsed.
+ */
+class ExclusiveGroupBase : public FlagBase {
+   protected:
+    // names of the members, in the order they were added
+    NameList flags;
+    FlagList members;
+    FlagSet memberSlots;
+    StringView _parsedValue;
+    // where the name of the parsed member is kept in ParseResults
+    size_t valueOffset = 0;
+
+   public:
+    ExclusiveGroupBase(Policy policy, const NameList& flags,
+                       const FlagList& members)
+        : FlagBase(policy, ""), flags(flags), members(members) {}
+
+    inline StringView parsedValue() const { return _parsedValue; }
+
+    /** The flag of this group parsed into `results`, empty if none was. */
+    inline StringView parsedValue(const ParseResults& results) const {
+        return (parsed(results))
+                   ? *static_cast<const StringView*>(results.value(valueOffset))
+                   : StringView();
+    }
+
+    inline const NameList& getFlagNames() const { return flags; }
+    inline const FlagSet& getMemberSlots() const { return memberSlots; }
+
+    /** Make `flag`, just added to `store`, a member of this group. */
+    void join(FlagStore& store, FlagBase& flag);
+
+    /** Record that the member named by `flag` was parsed. */
+    inline void memberParsed(ParseResults& results, ArgIter flag) const {
+        new (results.value(valueOffset)) StringView(*flag);
+        results.markParsed(*this);
+    }
+
+    inline virtual bool parse(ParseResults&, ArgIter&, ArgIter&) const {
+        std::cerr << "This should never be called\n";
+        abort();
+    }
+
+    inline virtual void printUsageHelp(std::ostream& os,
+                                       IndentedLine& lineIndent) const {
+        AutoArgParse::printUsageHelp(members, os, lineIndent);
+    }
+    inline virtual void printUsageSummary(std::ostream& os) const {
+        bool first = true;
+        for (const FlagBase* member : members) {
+            if (first) {
+                first = false;
+            } else {
+                os << "|";
+            }
+            os << member->name;
+            member->printUsageSummary(os);
+        }
+    }
+
+    virtual inline bool isExclusiveGroup() const { return true; }
+
+    virtual inline void attach(Schema* schema) {
+        FlagBase::attach(schema);
+        if (schema) {
+            valueOffset =
+                schema->addValue(sizeof(StringView), alignof(StringView));
+        }
+    }
+
+    virtual inline void commit(ParseResults& results) {
+        FlagBase::commit(results);
+        _available = false;
+        _parsedValue = parsedValue(results);
+    }
+
+    virtual inline void reset() {
+        FlagBase::reset();
+        _parsedValue = StringView();
+    }
+
+    virtual const FlagList& getFlagInsertionOrder() const { return members; }
+};
+
 /**
  * A non templated object that can hold most of the data belonging to templated
  * class ComplexFlag and implement some of its functions.  The purpose of this
@@ -73,28 +156,216 @@ void printUsageHelp(const std::deque<std::string>& flagInsertionOrder,
  * rather than having to inline the code in this file.
  */
 class FlagStore {
+    // holds strings when no arena is in use
+    std::forward_list<std::string> ownedStrings;
+
    public:
+    // nodes, names, descriptions and the containers below are allocated from
+    // the schema's arena, NULL until the store becomes part of an ArgParser
+    Schema* schema = NULL;
+    Arena* arena = NULL;
     FlagMap flags;
-    std::deque<std::string> flagInsertionOrder;
+    // what parsing looks flags up in, the same flags as above
+    FlagIndex<const FlagBase*> flagIndex;
+    // exclusive groups, which have no name and are not in the maps above
+    std::vector<FlagPtr, ArenaAllocator<FlagPtr>> groups;
+    // every flag and group by slot
+    std::vector<FlagBase*, ArenaAllocator<FlagBase*>> flagSlots;
+    // mandatory flags that are not in a group and mandatory groups
+    FlagSet mandatoryFlags;
+    // flags that are not in a group and groups, in the order they are printed
+    FlagList flagInsertionOrder;
     ArgVector args;
     int _numberMandatoryFlags = 0;
     int _numberOptionalFlags = 0;
     int _numberMandatoryArgs = 0;
     int _numberOptionalArgs = 0;
+    // where the positional cursor is kept in ParseResults, see tryParseArg
+    size_t cursorOffset = 0;
+    // this store's flags in schema->frozen once frozen, npos until then
+    size_t frozenStore = FrozenSchema::npos;
+
+    /** The flag named `token`, NULL if there is none. */
+    inline const FlagBase* findFlag(StringView token) const {
+        if (frozenStore != FrozenSchema::npos) {
+            return schema->frozen.find(frozenStore, token);
+        }
+        const FlagBase* const* found = flagIndex.find(token);
+        return (found) ? *found : NULL;
+    }
 
-    bool tryParseArg(ArgIter& first, ArgIter& last, Policy& foundArgPolicy);
-    bool tryParseFlag(ArgIter& first, ArgIter& last, Policy& foundFlagPolicy);
+    inline bool isFlag(StringView token) const {
+        return findFlag(token) != NULL;
+    }
 
-    void parse(ArgIter& first, ArgIter& last);
+    inline void checkNotFrozen() const {
+        if (frozenStore != FrozenSchema::npos) {
+            AUTOARGPARSE_THROW(std::logic_error(
+                "Flags and args cannot be added once the ArgParser is "
+                "frozen."));
+        }
+    }
+
+    /** Give `flag` the next slot and print it after the flags added so
+     * far.*/
+    inline void addSlot(FlagBase& flag) {
+        flag.slot = flagSlots.size();
+        flagSlots.push_back(&flag);
+        if (flag.policy == Policy::MANDATORY) {
+            mandatoryFlags.insert(flag.slot);
+        }
+        flagInsertionOrder.push_back(&flag);
+    }
+
+    /** Add `flag` under `name`, returns the flag of that name, which is the
+     * one already there if any.*/
+    inline FlagPtr& insertFlag(StringView name, FlagPtr&& flag) {
+        checkNotFrozen();
+        auto added = flags.insert(std::make_pair(name, std::move(flag)));
+        if (added.second) {
+            FlagBase& inserted = *added.first->second;
+            inserted.name = name;
+            flagIndex.insert(name, &inserted);
+            if (schema && !schema->findFlagName(name)) {
+                schema->flagNames.insert(name, &inserted);
+            }
+            if (schema && !inserted.built()) {
+                schema->lazyFlags.emplace(name, &inserted);
+            }
+            addSlot(inserted);
+        }
+        return added.first->second;
+    }
+
+    /** insertFlag() for flags, counting the flag by policy. */
+    inline FlagPtr& addFlag(StringView name, FlagPtr&& flag) {
+        FlagPtr& added = insertFlag(name, std::move(flag));
+        if (added->policy == Policy::MANDATORY) {
+            ++_numberMandatoryFlags;
+        } else {
+            ++_numberOptionalFlags;
+        }
+        return added;
+    }
+
+    inline ArgBase& addArg(ArgPtr&& arg) {
+        checkNotFrozen();
+        args.emplace_back(std::move(arg));
+        if (args.back()->policy == Policy::MANDATORY) {
+            ++_numberMandatoryArgs;
+        } else {
+            ++_numberOptionalArgs;
+        }
+        return *args.back();
+    }
+
+    inline FlagBase& insertGroup(FlagPtr&& group) {
+        checkNotFrozen();
+        groups.push_back(std::move(group));
+        addSlot(*groups.back());
+        return *groups.back();
+    }
+
+    /** Where the run of values for the list at args[index] must end. */
+    ArgIter endOfValues(ParseResults& results, size_t index,
+                        ArgIter first, ArgIter last) const;
+    /** The flag of this store named by `token`, a flag token, NULL if there
+     * is none. */
+    inline const FlagBase* findFlag(ParseResults& results,
+                                    ArgIter token) const {
+        const FlagBase* found = results.tokenFlag(token);
+        if (found->slot < flagSlots.size() && flagSlots[found->slot] == found) {
+            return found;
+        }
+        // another flag with that name, if any, is this store's
+        AUTOARGPARSE_COUNT(results, flagProbes, 1);
+        return findFlag(*token);
+    }
+
+    // both return whether the token was taken, or parsing stopped at it
+    bool tryParseArg(ParseResults& results, size_t& cursor, ArgIter& first,
+                     ArgIter& last, Policy& foundArgPolicy) const;
+    // `parsedFlags` is where the slots parsed are kept in results.flagBits, a
+    // flag with a nested store is left in `nested` for parse() to descend into
+    bool tryParseFlag(ParseResults& results, size_t parsedFlags, ArgIter& first,
+                      ArgIter& last, const FlagBase*& nested) const;
+    // what is left once `flag` of this store and its nested store are parsed
+    void flagParsed(ParseResults& results, const FlagBase& flag,
+                    ArgIter first, ArgIter last) const;
+    // start parsing this store, nested under `flag` named by `flagToken`
+    detail::ParseFrame beginParse(ParseResults& results, const FlagBase* flag,
+                                  StringView flagToken) const;
+    // whether this store got its mandatory flags and args, parsing stopped
+    // at `first`
+    bool checkMandatory(ParseResults& results, size_t parsedFlags,
+                        int numberParsedMandatoryArgs, ArgIter first,
+                        ArgIter last) const;
+    // drop the slots parsed by the store of `frame`
+    static void endParse(ParseResults& results,
+                         const detail::ParseFrame& frame);
+
+    /**
+     * Parse this store and the stores nested in it, in one loop over a stack
+     * of ParseFrames rather than by recursion.  Returns false if parsing must
+     * stop, see ParseResults::stopped().
+     */
+    bool parse(ParseResults& results, ArgIter& first, ArgIter& last) const;
     void printUsageSummary(std::ostream& os) const;
     virtual void printUsageHelp(std::ostream& os,
                                 IndentedLine& lineIndent) const;
     void rotateLeft();
-};
 
-void throwMoreThanOneExclusiveArgException(
-    const std::string& conflictingFlag1, const std::string& conflictingFlag2,
-    const std::deque<std::string>& exclusiveFlags);
+    /** Move this (still empty) store into `schema`. */
+    void attach(Schema* schema);
+
+    /** Move the flags of this store and of the stores nested in it into
+     * `frozen`, see ArgParser::freeze(). */
+    void freeze(FrozenSchema& frozen);
+
+    /** Heap memory held by the flag indexes of this store and the stores
+     * nested in it, the rest of the schema is in the arena. */
+    size_t indexBytesUsed() const;
+
+    /** Copy a name into storage owned by this store, or rather the
+     * schema's string pool when there is one. */
+    inline StringView copyName(StringView str) {
+        return (schema) ? schema->intern(str, schema->memory.names)
+                        : ownString(str);
+    }
+
+    inline StringView copyDescription(StringView str) {
+        return (schema) ? schema->intern(str, schema->memory.descriptions)
+                        : ownString(str);
+    }
+
+    inline StringView ownString(StringView str) {
+        ownedStrings.emplace_front(str.str());
+        return ownedStrings.front();
+    }
+
+    /** Create a node (flag or arg), inside the arena when there is one. Pass
+     * the result to a pointer using deleter().*/
+    template <typename T, typename... Args>
+    inline T* create(Args&&... args) {
+        T* node;
+        if (arena) {
+            size_t before = arena->bytesUsed();
+            node = arena->create<T>(std::forward<Args>(args)...);
+            schema->memory.nodes += arena->bytesUsed() - before;
+        } else {
+            node = new T(std::forward<Args>(args)...);
+        }
+        node->attach(schema);
+        return node;
+    }
+
+    inline NodeDeleter deleter() const { return NodeDeleter(arena != NULL); }
+
+    template <typename T>
+    inline ArenaAllocator<T> allocator() const {
+        return ArenaAllocator<T>(arena);
+    }
+};
 
 template <typename T>
 class ExclusiveFlagGroup;
@@ -106,25 +377,43 @@ class ComplexFlag : public Flag<OnParseTrigger> {
    protected:
     FlagStore store;
 
-    virtual void parse(ArgIter& first, ArgIter& last) {
-        int distance = (int)std::distance(first, last);
-        store.parse(first, last);
-        this->_parsed = true;
-        this->triggerParseSuccess(last[(0 - distance) - 1]);
+    virtual bool parse(ParseResults& results, ArgIter& first,
+                       ArgIter& last) const {
+        const StringView flag = first[-1];
+        {
+            AUTOARGPARSE_TIME(results, *this, this->name, true);
+            if (!store.parse(results, first, last)) {
+                return false;
+            }
+        }
+        this->triggerParseSuccess(flag);
+        return true;
+    }
+
+    virtual void nestedParsed(StringView flag) const {
+        this->triggerParseSuccess(flag);
     }
 
     inline const FlagStore& getFlagStore() { return store; }
 
+    virtual FlagStore* getNestedStore() { return &store; }
+    virtual const FlagStore* getNestedStore() const { return &store; }
+
    public:
     using Flag<OnParseTrigger>::Flag;
 
     inline const ArgVector& getArgs() const { return store.args; }
 
     const FlagMap& getFlagMap() const { return store.flags; }
-    const std::deque<std::string>& getFlagInsertionOrder() const {
+    const FlagList& getFlagInsertionOrder() const {
         return store.flagInsertionOrder;
     }
 
+    virtual inline void attach(Schema* schema) {
+        Flag<OnParseTrigger>::attach(schema);
+        store.attach(schema);
+    }
+
     inline int numberMandatoryArgs() { return store._numberMandatoryArgs; }
 
     inline int numberOptionalArgs() { return store._numberOptionalArgs; }
@@ -143,42 +432,37 @@ class ComplexFlag : public Flag<OnParseTrigger> {
     add(const std::string& flag, const Policy policy,
         const std::string& description,
         OnParseTriggerType&& trigger = DoNothingTrigger()) {
-        auto added = store.flags.insert(std::make_pair(
-            flag, std::unique_ptr<FlagBase>(new FlagType<OnParseTriggerType>(
-                      policy, description,
-                      std::forward<OnParseTriggerType>(trigger)))));
-        if (added.first->second->policy == Policy::MANDATORY) {
-            ++store._numberMandatoryFlags;
-        } else {
-            ++store._numberOptionalFlags;
-        }
-        store.flagInsertionOrder.emplace_back(flag);
+        StringView name = store.copyName(flag);
+        FlagPtr& added = store.addFlag(
+            name, FlagPtr(store.create<FlagType<OnParseTriggerType>>(
+                              policy, store.copyDescription(description),
+                              std::forward<OnParseTriggerType>(trigger)),
+                          store.deleter()));
         // get underlying raw pointer from unique pointer, used only for casting
         // purposes
-        return *(static_cast<FlagType<OnParseTriggerType>*>(
-            added.first->second.get()));
+        return *(static_cast<FlagType<OnParseTriggerType>*>(added.get()));
     }
 
     template <typename ArgType,
               typename ConverterFunc = Converter<typename ArgType::ValueType>,
               typename ArgValueType = typename ArgType::ValueType>
-    typename std::enable_if<std::is_base_of<ArgBase, ArgType>::value,
-                            Arg<ArgValueType, ConverterFunc>&>::type
+    typename std::enable_if<
+        std::is_base_of<ArgBase, ArgType>::value,
+        typename ArgType::template WithConverter<ConverterFunc>&>::type
     add(const std::string& name, const Policy policy,
         const std::string& description,
         ConverterFunc&& convert = Converter<ArgValueType>()) {
-        store.args.emplace_back(
-            std::unique_ptr<Arg<ArgValueType, ConverterFunc>>(
-                new Arg<ArgValueType, ConverterFunc>(
-                    name, policy, description,
-                    std::forward<ConverterFunc>(convert))));
-        if (store.args.back()->policy == Policy::MANDATORY) {
-            ++store._numberMandatoryArgs;
-        } else {
-            ++store._numberOptionalArgs;
+        typedef typename ArgType::template WithConverter<ConverterFunc> Added;
+        store.checkNotFrozen();
+        ArgBase& added = store.addArg(ArgPtr(
+            store.create<Added>(store.copyName(name), policy,
+                                store.copyDescription(description),
+                                std::forward<ConverterFunc>(convert)),
+            store.deleter()));
+        if (store.schema) {
+            store.schema->countConverter(detail::storedSize<ConverterFunc>());
         }
-        return *(static_cast<Arg<ArgValueType, ConverterFunc>*>(
-            store.args.back().get()));
+        return static_cast<Added&>(added);
     }
 
     inline void printUsageSummary(std::ostream& os) const {
@@ -190,93 +474,58 @@ class ComplexFlag : public Flag<OnParseTrigger> {
     }
     using Flag<OnParseTrigger>::printUsageHelp;
 };
-template <typename OnParseFunc>
-class ExclusiveFlagGroup : public FlagBase {
-    ComplexFlag<OnParseFunc>& parentFlag;
-    std::deque<std::string> flags;
-    const std::string* _parsedValue;
+
+/**
+ * A ComplexFlag whose flags and args are added by `factory`, called with the
+ * flag itself the first time a validated command line names it or usage is
+ * printed.  Subcommands that are not used then cost only their name and
+ * description.  Added as add<LazyFlag>(name, policy, description, factory),
+ * it has no trigger of its own.  See ArgParser::buildLazyFlags().
+ */
+template <typename Factory>
+class LazyFlag : public ComplexFlag<DoNothingTrigger> {
+    Factory factory;
+    bool _built = false;
 
    public:
-    const std::string& parsedValue() { return *_parsedValue; }
-    ExclusiveFlagGroup(ComplexFlag<OnParseFunc>& parentFlag, Policy policy)
-        : FlagBase(policy, ""), parentFlag(parentFlag) {}
+    LazyFlag(const Policy policy, StringView description, Factory&& factory)
+        : ComplexFlag<DoNothingTrigger>(policy, description,
+                                        DoNothingTrigger()),
+          factory(std::forward<Factory>(factory)) {}
 
-    inline virtual void parse(ArgIter&, ArgIter&) {
-        std::cerr << "This should never be called\n";
-        abort();
-    }
+    virtual inline bool built() const { return _built; }
 
-    inline virtual void printUsageHelp(std::ostream& os,
-                                       IndentedLine& lineIndent) const {
-        AutoArgParse::printUsageHelp(flags, parentFlag.getFlagMap(), os,
-                                     lineIndent);
-    }
-    inline virtual void printUsageSummary(std::ostream& os) const {
-        if (flags.empty()) {
-            return;
-        }
-        bool first = true;
-        for (const auto& flag : flags) {
-            auto& flagObj = parentFlag.getFlagMap().at(flag);
-            if (first) {
-                first = false;
-            } else {
-                os << "|";
-            }
-            os << flag;
-            flagObj->printUsageSummary(os);
+    virtual inline void build() {
+        if (!_built) {
+            _built = true;
+            factory(static_cast<ComplexFlag<DoNothingTrigger>&>(*this));
         }
-    };
+    }
+};
 
-    /**
-     * Wrapper around OnParseTriggers, insures exclusivity before  allowing a
-     * successful parse
-     */
-    template <typename OnParseTriggerType>
-    struct ExclusiveWrapper {
-        ExclusiveFlagGroup<OnParseFunc>* parentGroup;
-        OnParseTriggerType onParseSuccess;
-        ExclusiveWrapper(ExclusiveFlagGroup<OnParseFunc>* parentGroup,
-                         OnParseTriggerType&& onParseSuccess)
-            : parentGroup(parentGroup), onParseSuccess(onParseSuccess) {}
-
-        void operator()(const std::string& flag) {
-            if (parentGroup->_parsed) {
-                throwMoreThanOneExclusiveArgException(
-                    parentGroup->parsedValue(), flag, parentGroup->flags);
-            }
-            parentGroup->_parsed = true;
-            parentGroup->_available = false;
-            parentGroup->_parsedValue = &flag;
-            onParseSuccess(flag);
-        }
-    };
+template <typename OnParseFunc>
+class ExclusiveFlagGroup : public ExclusiveGroupBase {
+    ComplexFlag<OnParseFunc>& parentFlag;
+
+   public:
+    ExclusiveFlagGroup(ComplexFlag<OnParseFunc>& parentFlag, Policy policy)
+        : ExclusiveGroupBase(
+              policy,
+              NameList(parentFlag.store.template allocator<StringView>()),
+              FlagList(parentFlag.store.template allocator<const FlagBase*>())),
+          parentFlag(parentFlag) {}
 
     template <template <class T> class FlagType,
               typename OnParseTriggerType = DoNothingTrigger>
-    FlagType<ExclusiveWrapper<OnParseTriggerType>>& add(
+    FlagType<OnParseTriggerType>& add(
         const std::string& flag, const std::string& description,
         OnParseTriggerType&& trigger = DoNothingTrigger()) {
-        typedef ExclusiveWrapper<OnParseTriggerType> ExclusiveEnforcer;
         auto& flagObj = parentFlag.template add<FlagType>(
             flag, policy, description,
-            ExclusiveEnforcer(this, std::forward<OnParseTriggerType>(trigger)));
-        flags.push_back(std::move(parentFlag.store.flagInsertionOrder.back()));
-        parentFlag.store.flagInsertionOrder.pop_back();
-        if (flags.size() > 1) {
-            if (policy == Policy::MANDATORY) {
-                --parentFlag.store._numberMandatoryFlags;
-            } else {
-                --parentFlag.store._numberOptionalFlags;
-            }
-        }
+            std::forward<OnParseTriggerType>(trigger));
+        join(parentFlag.store, flagObj);
         return flagObj;
     }
-    virtual inline bool isExclusiveGroup() { return true; }
-
-    virtual const std::deque<std::string>& getFlagInsertionOrder() const {
-        return flags;
-    }
 
     /**indevelopment
         template <template <class T> class FlagType, typename... StringFlags>
@@ -288,12 +537,9 @@ class ExclusiveFlagGroup : public FlagBase {
 template <typename T>
 inline ExclusiveFlagGroup<T>& ComplexFlag<T>::makeExclusiveGroup(
     Policy policy) {
-    std::string randomName = std::to_string(store.flags.size()) + RANDOM_STRING;
-    auto flagIter = store.flags.insert(std::make_pair(
-        randomName,
-        std::unique_ptr<FlagBase>(new ExclusiveFlagGroup<T>(*this, policy))));
-    store.flagInsertionOrder.push_back(randomName);
-    return *(static_cast<ExclusiveFlagGroup<T>*>(flagIter.first->second.get()));
+    FlagBase& group = store.insertGroup(FlagPtr(
+        store.create<ExclusiveFlagGroup<T>>(*this, policy), store.deleter()));
+    return static_cast<ExclusiveFlagGroup<T>&>(group);
 }
 }  // namespace AutoArgParse
 #endif /* AUTOARGPARSE_FLAGS_H_ */
@@ -0,0 +1,166 @@
+#ifndef AUTOARGPARSE_FROZENSCHEMA_H_
+#define AUTOARGPARSE_FROZENSCHEMA_H_
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "stringView.h"
+namespace AutoArgParse {
+class FlagBase;
+
+/**
+ * The flag tables of every FlagStore of an ArgParser, packed into a few
+ * arrays once the schema is complete (see ArgParser::freeze()).  The flags of
+ * each store are a contiguous range of `flags` and their names are kept in a
+ * single pool, each distinct name once.  Small stores are scanned, larger
+ * ones also get a contiguous, power of two sized range of hash `slots`.
+ * Stores without flags all share the empty store 0, so a tree of thousands of
+ * leaf subcommands adds nothing here.
+ */
+class FrozenSchema {
+    struct Flag {
+        uint32_t nameOffset;
+        uint32_t nameSize;
+        const FlagBase* flag;
+    };
+    // index + 1 into flags, 0 if empty, next to the low bits of its hash
+    struct Slot {
+        uint32_t flag;
+        uint32_t hash;
+    };
+    struct Store {
+        uint32_t firstFlag;
+        uint32_t numberFlags;
+        // 0 when the flags are scanned
+        uint32_t firstSlot;
+        uint32_t numberSlots;
+        uint32_t maxLength;
+    };
+    // stores with more flags than this are hashed
+    static const size_t MAX_SCANNED_FLAGS = 8;
+    std::vector<char> names;
+    std::vector<Flag> flags;
+    std::vector<Slot> slots;
+    std::vector<Store> stores = {Store{0, 0, 0, 0, 0}};
+    // first characters of every name of every store
+    uint64_t firstCharacters[4] = {0, 0, 0, 0};
+    // flags of the store being added, see addFlag()
+    size_t storeBegin = 0;
+    // offset in names of every name added, until shrink()
+    std::unordered_map<StringView, uint32_t, StringViewHash> nameOffsets;
+
+    template <typename T>
+    static inline size_t bytes(const std::vector<T>& v) {
+        return v.capacity() * sizeof(T);
+    }
+
+   public:
+    static const size_t npos = static_cast<size_t>(-1);
+
+    /** Add a flag to the store being built, see endStore(). */
+    inline void addFlag(StringView name, const FlagBase* flag) {
+        auto offset = nameOffsets.insert(
+            std::make_pair(name, static_cast<uint32_t>(names.size())));
+        if (offset.second) {
+            names.insert(names.end(), name.begin(), name.end());
+        }
+        flags.push_back({offset.first->second,
+                         static_cast<uint32_t>(name.size()), flag});
+        if (!name.empty()) {
+            unsigned char c = static_cast<unsigned char>(name[0]);
+            firstCharacters[c / 64] |= uint64_t(1) << (c % 64);
+        }
+    }
+
+    /** Finish the store holding the flags added since the last call, returns
+     * its index. */
+    inline size_t endStore() {
+        const size_t numberFlags = flags.size() - storeBegin;
+        if (numberFlags == 0) {
+            return 0;
+        }
+        Store store = {static_cast<uint32_t>(storeBegin),
+                       static_cast<uint32_t>(numberFlags), 0, 0, 0};
+        for (size_t i = storeBegin; i < flags.size(); i++) {
+            store.maxLength = std::max(store.maxLength, flags[i].nameSize);
+        }
+        if (numberFlags > MAX_SCANNED_FLAGS) {
+            store.firstSlot = static_cast<uint32_t>(slots.size());
+            store.numberSlots = 16;
+            while (store.numberSlots < numberFlags * 2) {
+                store.numberSlots *= 2;
+            }
+            slots.resize(slots.size() + store.numberSlots, Slot{0, 0});
+            Slot* storeSlots = slots.data() + store.firstSlot;
+            const size_t mask = store.numberSlots - 1;
+            for (size_t i = storeBegin; i < flags.size(); i++) {
+                size_t hash = StringViewHash()(name(flags[i]));
+                size_t slot = hash & mask;
+                while (storeSlots[slot].flag != 0) {
+                    slot = (slot + 1) & mask;
+                }
+                storeSlots[slot] = {static_cast<uint32_t>(i + 1),
+                                    static_cast<uint32_t>(hash)};
+            }
+        }
+        storeBegin = flags.size();
+        stores.push_back(store);
+        return stores.size() - 1;
+    }
+
+    /** Release the room left for growth once every store was added. */
+    inline void shrink() {
+        decltype(nameOffsets)().swap(nameOffsets);
+        names.shrink_to_fit();
+        flags.shrink_to_fit();
+        slots.shrink_to_fit();
+        stores.shrink_to_fit();
+    }
+
+    inline StringView name(const Flag& flag) const {
+        return StringView(names.data() + flag.nameOffset, flag.nameSize);
+    }
+
+    /** The flag of store `store` named `token`, NULL if there is none. */
+    inline const FlagBase* find(size_t store, StringView token) const {
+        const Store& s = stores[store];
+        if (token.size() > s.maxLength || s.numberFlags == 0) {
+            return NULL;
+        }
+        if (!token.empty()) {
+            unsigned char c = static_cast<unsigned char>(token[0]);
+            if (!((firstCharacters[c / 64] >> (c % 64)) & 1)) {
+                return NULL;
+            }
+        }
+        if (s.numberSlots == 0) {
+            const Flag* flag = flags.data() + s.firstFlag;
+            for (const Flag* end = flag + s.numberFlags; flag != end; ++flag) {
+                if (flag->nameSize == token.size() && name(*flag) == token) {
+                    return flag->flag;
+                }
+            }
+            return NULL;
+        }
+        const size_t hash = StringViewHash()(token);
+        const Slot* storeSlots = slots.data() + s.firstSlot;
+        const size_t mask = s.numberSlots - 1;
+        for (size_t slot = hash & mask; storeSlots[slot].flag != 0;
+             slot = (slot + 1) & mask) {
+            if (storeSlots[slot].hash == static_cast<uint32_t>(hash)) {
+                const Flag& flag = flags[storeSlots[slot].flag - 1];
+                if (name(flag) == token) {
+                    return flag.flag;
+                }
+            }
+        }
+        return NULL;
+    }
+
+    /** Heap memory held by the tables. */
+    inline size_t bytesUsed() const {
+        return bytes(names) + bytes(flags) + bytes(slots) + bytes(stores);
+    }
+};
+}  // namespace AutoArgParse
+#endif /* AUTOARGPARSE_FROZENSCHEMA_H_ */
@@ -0,0 +1,146 @@
+#ifndef AUTOARGPARSE_HELPTEXT_H_
+#define AUTOARGPARSE_HELPTEXT_H_
+#include <cstdlib>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/ioctl.h>
+#include <unistd.h>
+#define AUTOARGPARSE_HAVE_TERMINAL_SIZE 1
+#else
+#define AUTOARGPARSE_HAVE_TERMINAL_SIZE 0
+#endif
+
+namespace AutoArgParse {
+
+/**
+ * Collects usage text into one string, wrapping lines longer than `width` as
+ * the text is written.  A line is broken at its last space before the limit
+ * and continues with the same leading indentation.  Width 0 never wraps.
+ */
+class HelpTextBuffer : public std::streambuf {
+    std::string text;
+    size_t width;
+    // where the current line starts and how far it is indented
+    size_t lineStart = 0;
+    size_t indent = 0;
+    bool inIndent = true;
+    // position of the last space the current line may be broken at
+    size_t breakPoint = 0;
+
+    inline void put(char c) {
+        text.push_back(c);
+        if (c == '\n') {
+            lineStart = text.size();
+            indent = 0;
+            inIndent = true;
+            breakPoint = 0;
+            return;
+        }
+        if (inIndent) {
+            if (c == ' ') {
+                ++indent;
+                return;
+            }
+            inIndent = false;
+        }
+        if (c == ' ') {
+            breakPoint = text.size() - 1;
+        }
+        if (width > 0 && text.size() - lineStart > width &&
+            breakPoint > lineStart + indent) {
+            text[breakPoint] = '\n';
+            text.insert(breakPoint + 1, indent, ' ');
+            lineStart = breakPoint + 1;
+            breakPoint = 0;
+        }
+    }
+
+   protected:
+    virtual int_type overflow(int_type c) {
+        if (c != traits_type::eof()) {
+            put(traits_type::to_char_type(c));
+        }
+        return traits_type::not_eof(c);
+    }
+
+    virtual std::streamsize xsputn(const char* s, std::streamsize n) {
+        for (std::streamsize i = 0; i < n; i++) {
+            put(s[i]);
+        }
+        return n;
+    }
+
+   public:
+    explicit HelpTextBuffer(size_t width) : width(width) {}
+
+    inline std::string take() { return std::move(text); }
+};
+
+/**
+ * Width of the terminal `os` writes to, 0 if it is not std::cout or
+ * std::cerr or if these are not terminals.  The COLUMNS environment variable
+ * takes precedence.
+ */
+inline size_t terminalWidth(const std::ostream& os) {
+    int fd = (&os == &std::cout) ? 1
+             : (&os == &std::cerr || &os == &std::clog) ? 2
+                                                        : -1;
+    if (fd < 0) {
+        return 0;
+    }
+#if AUTOARGPARSE_HAVE_TERMINAL_SIZE
+    if (!isatty(fd)) {
+        return 0;
+    }
+    const char* columns = getenv("COLUMNS");
+    if (columns && atoi(columns) > 0) {
+        return atoi(columns);
+    }
+    struct winsize size;
+    if (ioctl(fd, TIOCGWINSZ, &size) == 0 && size.ws_col > 0) {
+        return size.ws_col;
+    }
+#endif
+    return 0;
+}
+
+namespace detail {
+/** Text rendered once, kept until the schema or the wrapping changes. */
+struct CachedText {
+    std::string text;
+    size_t numberTokens = static_cast<size_t>(-1);
+    size_t width = 0;
+    std::string key;
+
+    /** `render(std::ostream&)` is only called when the cache is stale. */
+    template <typename Render>
+    inline const std::string& get(size_t schemaTokens, size_t wrapWidth,
+                                  const std::string& renderKey,
+                                  Render&& render) {
+        if (numberTokens != schemaTokens || width != wrapWidth ||
+            key != renderKey) {
+            HelpTextBuffer buffer(wrapWidth);
+            std::ostream os(&buffer);
+            render(os);
+            text = buffer.take();
+            numberTokens = schemaTokens;
+            width = wrapWidth;
+            key = renderKey;
+        }
+        return text;
+    }
+};
+
+/** Emit `text` with one write, so that it is not interleaved with other
+ * output.*/
+inline void writeAll(std::ostream& os, const std::string& text) {
+    os.write(text.data(), text.size());
+    os.flush();
+}
+}  // namespace detail
+}  // namespace AutoArgParse
+#endif /* AUTOARGPARSE_HELPTEXT_H_ */
@@ -0,0 +1,294 @@
+#ifndef AUTOARGPARSE_MAPPEDFILE_H_
+#define AUTOARGPARSE_MAPPEDFILE_H_
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include "argHandlers.h"
+#include "stringView.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define AUTOARGPARSE_HAVE_MMAP 1
+#else
+#define AUTOARGPARSE_HAVE_MMAP 0
+#endif
+
+namespace AutoArgParse {
+
+/**
+ * The contents of a file, memory mapped where the platform allows and read
+ * into memory otherwise.  Files opened with open() are mapped privately: the
+ * contents may be modified in place (only the pages written to are copied)
+ * and changes never reach the file.  Files opened with openForWriting() are
+ * shared, writes go to the file.  Views into the contents stay valid when a
+ * MappedFile is moved.
+ */
+class MappedFile {
+    char* _data = NULL;
+    size_t _size = 0;
+    // holds the contents when they could not be mapped
+    std::unique_ptr<char[]> buffer;
+    // where the buffer is written back on release, when opened for writing
+    // without mmap
+    std::string writeBackPath;
+
+    inline void release() {
+#if AUTOARGPARSE_HAVE_MMAP
+        if (_data && !buffer) {
+            munmap(_data, _size);
+        }
+#endif
+        if (!writeBackPath.empty()) {
+            std::ofstream file(writeBackPath, std::ios::binary);
+            file.write(_data, _size);
+            writeBackPath.clear();
+        }
+        buffer.reset();
+        _data = NULL;
+        _size = 0;
+    }
+
+    static inline bool openError(const std::string& path, std::string& error,
+                                 const char* action = "read") {
+        error = "Could not " + std::string(action) + " " + path + ": " +
+                strerror(errno);
+        return false;
+    }
+
+#if AUTOARGPARSE_HAVE_MMAP
+    /** Read `fd` to its end into the buffer, for files that cannot be mapped
+     * and whose size is not known up front, such as pipes. */
+    inline bool readAll(int fd) {
+        size_t capacity = 4096;
+        size_t size = 0;
+        std::unique_ptr<char[]> contents(new char[capacity + 1]);
+        while (true) {
+            if (size == capacity) {
+                std::unique_ptr<char[]> grown(new char[capacity * 2 + 1]);
+                memcpy(grown.get(), contents.get(), size);
+                contents = std::move(grown);
+                capacity *= 2;
+            }
+            ssize_t count = read(fd, contents.get() + size, capacity - size);
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            if (count == 0) {
+                break;
+            }
+            size += count;
+        }
+        buffer = std::move(contents);
+        _data = buffer.get();
+        _size = size;
+        return true;
+    }
+#endif
+
+   public:
+    MappedFile() = default;
+
+    /** Throws ErrorMessage if the file cannot be read.*/
+    explicit MappedFile(const std::string& path) {
+        std::string error;
+        if (!open(path, error)) {
+            AUTOARGPARSE_THROW(ErrorMessage(error));
+        }
+    }
+
+    /**
+     * Replace the contents by those of the file at `path`.  Returns false and
+     * describes the problem in `error` if the file cannot be read, the
+     * contents are then empty.  Regular files are mapped, others such as
+     * pipes and `/dev/fd/N` are read to their end.
+     */
+    inline bool open(const std::string& path, std::string& error) {
+        release();
+#if AUTOARGPARSE_HAVE_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return openError(path, error);
+        }
+        struct stat status;
+        if (fstat(fd, &status) != 0) {
+            int savedErrno = errno;
+            close(fd);
+            errno = savedErrno;
+            return openError(path, error);
+        }
+        if (!S_ISREG(status.st_mode)) {
+            bool read = readAll(fd);
+            int savedErrno = errno;
+            close(fd);
+            errno = savedErrno;
+            return (read) ? true : openError(path, error);
+        }
+        size_t size = status.st_size;
+        if (size > 0) {
+            void* mapping = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                                 MAP_PRIVATE, fd, 0);
+            if (mapping == MAP_FAILED) {
+                int savedErrno = errno;
+                close(fd);
+                errno = savedErrno;
+                return openError(path, error);
+            }
+            _data = static_cast<char*>(mapping);
+            _size = size;
+        }
+        close(fd);
+#else
+        // read to the end rather than seeking it, pipes cannot seek
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return openError(path, error);
+        }
+        std::string contents;
+        char chunk[4096];
+        while (file.read(chunk, sizeof(chunk)) || file.gcount() > 0) {
+            contents.append(chunk, static_cast<size_t>(file.gcount()));
+        }
+        if (file.bad()) {
+            return openError(path, error);
+        }
+        _size = contents.size();
+        buffer.reset(new char[_size + 1]);
+        memcpy(buffer.get(), contents.data(), _size);
+        _data = buffer.get();
+#endif
+        return true;
+    }
+
+    /**
+     * Create or truncate the file at `path`, grow it to `size` bytes and map
+     * it so that writes to the contents reach the file.  Returns false and
+     * describes the problem in `error` if the file cannot be written, the
+     * contents are then empty.
+     */
+    inline bool openForWriting(const std::string& path, size_t size,
+                               std::string& error) {
+        release();
+#if AUTOARGPARSE_HAVE_MMAP
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0666);
+        if (fd < 0) {
+            return openError(path, error, "write");
+        }
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            int savedErrno = errno;
+            close(fd);
+            errno = savedErrno;
+            return openError(path, error, "write");
+        }
+        if (size > 0) {
+            void* mapping =
+                mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (mapping == MAP_FAILED) {
+                int savedErrno = errno;
+                close(fd);
+                errno = savedErrno;
+                return openError(path, error, "write");
+            }
+            _data = static_cast<char*>(mapping);
+            _size = size;
+        }
+        close(fd);
+#else
+        if (!std::ofstream(path, std::ios::binary)) {
+            return openError(path, error, "write");
+        }
+        buffer.reset(new char[size + 1]());
+        _data = buffer.get();
+        _size = size;
+        writeBackPath = path;
+#endif
+        return true;
+    }
+
+    MappedFile(MappedFile&& other)
+        : _data(other._data),
+          _size(other._size),
+          buffer(std::move(other.buffer)),
+          writeBackPath(std::move(other.writeBackPath)) {
+        other._data = NULL;
+        other._size = 0;
+        other.writeBackPath.clear();
+    }
+
+    inline MappedFile& operator=(MappedFile&& other) {
+        if (this != &other) {
+            release();
+            _data = other._data;
+            _size = other._size;
+            buffer = std::move(other.buffer);
+            writeBackPath = std::move(other.writeBackPath);
+            other._data = NULL;
+            other._size = 0;
+            other.writeBackPath.clear();
+        }
+        return *this;
+    }
+
+    ~MappedFile() { release(); }
+
+    inline char* data() { return _data; }
+    inline const char* data() const { return _data; }
+    inline size_t size() const { return _size; }
+    inline StringView view() const { return StringView(_data, _size); }
+    inline char* begin() { return _data; }
+    inline char* end() { return _data + _size; }
+    inline const char* begin() const { return _data; }
+    inline const char* end() const { return _data + _size; }
+};
+
+/**
+ * Maps the file named by the token, e.g. Arg<MappedFile>, as a zero copy
+ * alternative to Converter<std::ifstream>.  The file itself is never
+ * modified.  Pipes, e.g. `<(command)`, are read rather than mapped, see
+ * MappedFile::open().
+ */
+template <>
+struct Converter<MappedFile> {
+    inline ConversionResult<MappedFile> tryConvert(StringView path) const {
+        MappedFile file;
+        std::string error;
+        if (!file.open(path.str(), error)) {
+            return ConversionError(std::move(error));
+        }
+        return file;
+    }
+    inline MappedFile operator()(StringView path) const {
+        return detail::valueOrThrow(tryConvert(path));
+    }
+};
+
+/**
+ * Creates the file named by the token with `size` bytes and maps it for
+ * writing, the counterpart of Converter<std::ofstream>, see
+ * MappedFile::openForWriting().
+ */
+struct WritableMappedFile {
+    size_t size;
+    explicit WritableMappedFile(size_t size) : size(size) {}
+
+    inline ConversionResult<MappedFile> tryConvert(StringView path) const {
+        MappedFile file;
+        std::string error;
+        if (!file.openForWriting(path.str(), size, error)) {
+            return ConversionError(std::move(error));
+        }
+        return file;
+    }
+    inline MappedFile operator()(StringView path) const {
+        return detail::valueOrThrow(tryConvert(path));
+    }
+};
+}  // namespace AutoArgParse
+#endif /* AUTOARGPARSE_MAPPEDFILE_H_ */
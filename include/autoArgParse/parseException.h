@@ -8,17 +8,16 @@
 #include "argParser.h"
 namespace AutoArgParse {
 
-void printUnParsed(std::ostringstream& os,
-                   const std::deque<std::string>& flagInsertionOrder,
-                   const FlagMap& flags) {
+inline void printUnParsed(std::ostringstream& os,
+                          const FlagList& flagInsertionOrder,
+                          const ParseResults& results) {
     bool first = true;
-    for (auto& flag : flagInsertionOrder) {
-        auto& flagObj = flags.at(flag);
+    for (const FlagBase* flagObj : flagInsertionOrder) {
         if (flagObj->isExclusiveGroup()) {
-            printUnParsed(os, flagObj->getFlagInsertionOrder(), flags);
+            printUnParsed(os, flagObj->getFlagInsertionOrder(), results);
             continue;
         }
-        if (!flagObj->parsed() && flagObj->available()) {
+        if (!flagObj->parsed(results) && flagObj->available()) {
             if (first) {
                 os << " ";
                 first = false;
@@ -28,7 +27,7 @@ void printUnParsed(std::ostringstream& os,
             if (flagObj->policy == Policy::OPTIONAL) {
                 os << "[";
             }
-            os << flag;
+            os << flagObj->name;
             if (flagObj->policy == Policy::OPTIONAL) {
                 os << "]";
             }
@@ -36,9 +35,10 @@ void printUnParsed(std::ostringstream& os,
     }
 }
 
-void printUnParsed(std::ostringstream& os, const ArgVector& args) {
+inline void printUnParsed(std::ostringstream& os, const ArgVector& args,
+                          const ParseResults& results) {
     for (auto& argPtr : args) {
-        if (!argPtr->parsed()) {
+        if (!argPtr->parsed(results)) {
             os << " ";
             if (argPtr->policy == Policy::OPTIONAL) {
                 os << "[";
@@ -51,15 +51,6 @@ void printUnParsed(std::ostringstream& os, const ArgVector& args) {
     }
 }
 
-enum ParseFailureReason {
-    MISSING_MANDATORY_FLAG,
-    REPEATED_FLAG,
-    MISSING_MANDATORY_ARG,
-    UNEXPECTED_ARG,
-    MORE_THAN_ONE_EXCLUSIVE_ARG,
-    FAILED_ARG_CONVERSION
-};
-
 class ParseException : public std::exception {
    public:
     const ParseFailureReason failureReason;
@@ -77,13 +68,16 @@ class MissingMandatoryArgException : public ParseException {
    public:
     const FlagStore& flagStore;
 
-    MissingMandatoryArgException(const FlagStore& flagStore)
-        : ParseException(MISSING_MANDATORY_ARG, makeErrorMessage(flagStore)),
+    MissingMandatoryArgException(const FlagStore& flagStore,
+                                 const ParseResults& results)
+        : ParseException(MISSING_MANDATORY_ARG,
+                         makeErrorMessage(flagStore, results)),
           flagStore(flagStore) {}
-    static std::string makeErrorMessage(const FlagStore& flagStore) {
+    static std::string makeErrorMessage(const FlagStore& flagStore,
+                                        const ParseResults& results) {
         std::ostringstream os;
         os << "Missing mandatory argument(s).  Valid option(s) are: ";
-        printUnParsed(os, flagStore.args);
+        printUnParsed(os, flagStore.args, results);
         return os.str();
     }
 };
@@ -92,13 +86,16 @@ class MissingMandatoryFlagException : public ParseException {
    public:
     const FlagStore& flagStore;
 
-    MissingMandatoryFlagException(const FlagStore& flagStore)
-        : ParseException(MISSING_MANDATORY_FLAG, makeErrorMessage(flagStore)),
+    MissingMandatoryFlagException(const FlagStore& flagStore,
+                                  const ParseResults& results)
+        : ParseException(MISSING_MANDATORY_FLAG,
+                         makeErrorMessage(flagStore, results)),
           flagStore(flagStore) {}
-    static std::string makeErrorMessage(const FlagStore& flagStore) {
+    static std::string makeErrorMessage(const FlagStore& flagStore,
+                                        const ParseResults& results) {
         std::ostringstream os;
         os << "Missing mandatory argument(s). valid option(s) are: ";
-        printUnParsed(os, flagStore.flagInsertionOrder, flagStore.flags);
+        printUnParsed(os, flagStore.flagInsertionOrder, results);
         return os.str();
     }
 };
@@ -120,18 +117,20 @@ class UnexpectedArgException : public ParseException {
     const FlagStore& flagStore;
 
     UnexpectedArgException(std::string unexpectedArg,
-                           const FlagStore& flagStore)
+                           const FlagStore& flagStore,
+                           const ParseResults& results)
         : ParseException(UNEXPECTED_ARG,
-                         makeErrorMessage(unexpectedArg, flagStore)),
+                         makeErrorMessage(unexpectedArg, flagStore, results)),
           unexpectedArg(std::move(unexpectedArg)),
           flagStore(flagStore) {}
     static std::string makeErrorMessage(const std::string& unexpectedArg,
-                                        const FlagStore& flagStore) {
+                                        const FlagStore& flagStore,
+                                        const ParseResults& results) {
         std::ostringstream os;
         os << "Unexpected argument: " << unexpectedArg << std::endl;
         os << "Valid option(s): ";
-        printUnParsed(os, flagStore.flagInsertionOrder, flagStore.flags);
-        printUnParsed(os, flagStore.args);
+        printUnParsed(os, flagStore.flagInsertionOrder, results);
+        printUnParsed(os, flagStore.args, results);
         return os.str();
     }
 };
@@ -140,22 +139,20 @@ class MoreThanOneExclusiveArgException : public ParseException {
    public:
     const std::string conflictingFlag1;
     const std::string conflictingFlag2;
-    const std::deque<std::string>& exclusiveFlags;
+    const NameList& exclusiveFlags;
 
-    MoreThanOneExclusiveArgException(
-        const std::string& conflictingFlag1,
-        const std::string& conflictingFlag2,
-        const std::deque<std::string>& exclusiveFlags)
+    MoreThanOneExclusiveArgException(const std::string& conflictingFlag1,
+                                     const std::string& conflictingFlag2,
+                                     const NameList& exclusiveFlags)
         : ParseException(MORE_THAN_ONE_EXCLUSIVE_ARG,
                          makeErrorMessage(conflictingFlag1, conflictingFlag2,
                                           exclusiveFlags)),
           conflictingFlag1(conflictingFlag1),
           conflictingFlag2(conflictingFlag2),
           exclusiveFlags(exclusiveFlags) {}
-    static std::string makeErrorMessage(
-        const std::string& conflictingFlag1,
-        const std::string& conflictingFlag2,
-        const std::deque<std::string>& exclusiveFlags) {
+    static std::string makeErrorMessage(const std::string& conflictingFlag1,
+                                        const std::string& conflictingFlag2,
+                                        const NameList& exclusiveFlags) {
         std::ostringstream os;
         os << "Cannot use " << conflictingFlag1 << " in conjunction with "
            << conflictingFlag2 << ".\nThe following flags are exclusive:\n";
@@ -189,5 +186,34 @@ class FailedArgConversionException : public ParseException {
                "\n";
     }
 };
+
+class ResponseFileException : public ParseException {
+   public:
+    const std::string path;
+    const std::string additionalExpl;
+    ResponseFileException(const std::string& path,
+                          const std::string& additionalExpl)
+        : ParseException(INVALID_RESPONSE_FILE,
+                         makeErrorMessage(path, additionalExpl)),
+          path(path),
+          additionalExpl(additionalExpl) {}
+    static std::string makeErrorMessage(const std::string& path,
+                                        const std::string& additionalExpl) {
+        return "Invalid response file: " + path + "\n" + additionalExpl +
+               "\n";
+    }
+};
+
+class LazyFlagNotBuiltException : public ParseException {
+   public:
+    const std::string lazyFlag;
+    LazyFlagNotBuiltException(std::string lazyFlag)
+        : ParseException(LAZY_FLAG_NOT_BUILT, makeErrorMessage(lazyFlag)),
+          lazyFlag(std::move(lazyFlag)) {}
+    static std::string makeErrorMessage(const std::string& flag) {
+        return "Lazy flag not built: " + flag +
+               "\nCall ArgParser::buildLazyFlags() before parseArgs().\n";
+    }
+};
 }  // namespace AutoArgParse
 #endif /* AUTOARGPARSE_PARSEEXCEPTION_H_ */
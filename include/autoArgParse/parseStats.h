@@ -0,0 +1,80 @@
+#ifndef AUTOARGPARSE_PARSESTATS_H_
+#define AUTOARGPARSE_PARSESTATS_H_
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "stringView.h"
+
+/**
+ * Parsing is instrumented only when built with AUTOARGPARSE_STATS=1.
+ * Otherwise the hooks below expand to nothing and ParseStats stays zero.
+ */
+#ifndef AUTOARGPARSE_STATS
+#define AUTOARGPARSE_STATS 0
+#endif
+
+#if AUTOARGPARSE_STATS
+#define AUTOARGPARSE_COUNT(results, counter, n) ((results).stats.counter += (n))
+#define AUTOARGPARSE_TIME(results, node, name, subtree)                  \
+    ::AutoArgParse::detail::NodeTimer autoArgParseNodeTimer((results), \
+                                                            (node), (name), \
+                                                            (subtree))
+#else
+#define AUTOARGPARSE_COUNT(results, counter, n) ((void)0)
+#define AUTOARGPARSE_TIME(results, node, name, subtree) ((void)0)
+#endif
+
+namespace AutoArgParse {
+class ParseToken;
+
+/**
+ * Where a parse spent its effort, see ParseResults::stats and
+ * ArgParser::reportStats().  Conversions run on a ConversionPool are counted
+ * but not timed per converter, and LazyArg conversions happen after parsing
+ * and are not counted.
+ */
+struct ParseStats {
+    static const bool enabled = AUTOARGPARSE_STATS != 0;
+
+    /** Time spent converting for one arg, or in the subtree of one flag. */
+    struct NodeTime {
+        const ParseToken* node = NULL;
+        StringView name;
+        // a ComplexFlag subtree, including the time of the subtrees and
+        // converters below it
+        bool subtree = false;
+        uint64_t calls = 0;
+        uint64_t nanoseconds = 0;
+    };
+
+    // the whole of ArgParser::parseArgs()
+    uint64_t nanoseconds = 0;
+    // tokens offered to a flag store, once per store they pass through
+    uint64_t tokensExamined = 0;
+    // lookups of a token in a flag table
+    uint64_t flagProbes = 0;
+    uint64_t conversions = 0;
+    // tokens turned down by optional args, which then go to the next taker
+    uint64_t rejectedOptionalArgs = 0;
+    // converters rejecting a token by throwing, and exceptions escaping
+    // converters or triggers
+    uint64_t exceptionsThrown = 0;
+    // by node, entries that were never timed have no calls
+    std::vector<NodeTime> nodes;
+
+    inline void clear() {
+        nanoseconds = tokensExamined = flagProbes = conversions =
+            rejectedOptionalArgs = exceptionsThrown = 0;
+        nodes.clear();
+    }
+};
+
+namespace detail {
+inline uint64_t nanosecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+}  // namespace detail
+}  // namespace AutoArgParse
+#endif /* AUTOARGPARSE_PARSESTATS_H_ */
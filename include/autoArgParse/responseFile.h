@@ -0,0 +1,93 @@
+#ifndef AUTOARGPARSE_RESPONSEFILE_H_
+#define AUTOARGPARSE_RESPONSEFILE_H_
+#include "argHandlers.h"
+#include "stringView.h"
+namespace AutoArgParse {
+
+/**
+ * Splits the contents of a response file into tokens one at a time.  Tokens
+ * are separated by whitespace and may be quoted as in a POSIX shell: 'single
+ * quotes' keep everything literally, "double quotes" allow \" and \\, and a
+ * backslash outside quotes escapes the next character.  Quotes and escapes
+ * are removed by moving the characters in place, so every token is a view of
+ * the buffer given to the tokenizer and nothing is copied.  The buffer must
+ * therefore be writable, it is only written to when a token contains quotes
+ * or escapes.
+ */
+class ResponseFileTokenizer {
+    char* pos;
+    char* end;
+    const char* _error = NULL;
+
+    inline bool fail(const char* error) {
+        _error = error;
+        pos = end;
+        return false;
+    }
+
+    static inline bool isSeparator(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' ||
+               c == '\v';
+    }
+
+   public:
+    ResponseFileTokenizer(char* data, size_t size)
+        : pos(data), end(data + size) {}
+
+    /**
+     * Store the next token in `token`, return false once the buffer is
+     * exhausted or on an unterminated quote or a trailing backslash, see
+     * error().
+     */
+    inline bool next(StringView& token) {
+        while (pos != end && isSeparator(*pos)) {
+            ++pos;
+        }
+        if (pos == end) {
+            return false;
+        }
+        char* start = pos;
+        // write cursor, trails pos once a quote or escape has been removed
+        char* out = pos;
+        while (pos != end && !isSeparator(*pos)) {
+            char c = *pos++;
+            if (c == '\'') {
+                while (pos != end && *pos != '\'') {
+                    *out++ = *pos++;
+                }
+                if (pos == end) {
+                    return fail("unterminated single quote");
+                }
+                ++pos;
+            } else if (c == '"') {
+                while (pos != end && *pos != '"') {
+                    if (*pos == '\\' && pos + 1 != end &&
+                        (pos[1] == '"' || pos[1] == '\\')) {
+                        ++pos;
+                    }
+                    *out++ = *pos++;
+                }
+                if (pos == end) {
+                    return fail("unterminated double quote");
+                }
+                ++pos;
+            } else if (c == '\\') {
+                if (pos == end) {
+                    return fail("trailing backslash");
+                }
+                *out++ = *pos++;
+            } else if (out != pos - 1) {
+                *out++ = c;
+            } else {
+                ++out;
+            }
+        }
+        token = StringView(start, out - start);
+        return true;
+    }
+
+    /** Why next() stopped early, NULL if the buffer was well formed. */
+    inline const char* error() const { return _error; }
+};
+}  // namespace AutoArgParse
+#endif /* AUTOARGPARSE_RESPONSEFILE_H_ */
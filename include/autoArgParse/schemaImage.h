@@ -0,0 +1,158 @@
+#ifndef AUTOARGPARSE_SCHEMAIMAGE_H_
+#define AUTOARGPARSE_SCHEMAIMAGE_H_
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+#include "args.h"
+#include "flags.h"
+namespace AutoArgParse {
+
+/**
+ * Layout of the binary image of a schema, see ArgParser::saveSchema().  The
+ * image is the header, then the binding ids, the nodes, the print groups,
+ * the print group members and last the string pool.  Strings are offsets
+ * into the pool, so a loaded parser refers to the names and descriptions of
+ * the image rather than copying them.  Records are in the byte order of the
+ * machine that wrote them.
+ */
+struct SchemaImage {
+    static const uint32_t VERSION = 1;
+
+    struct String {
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint32_t numberBindings;
+        uint32_t numberNodes;
+        uint32_t numberPrintGroups;
+        uint32_t numberMembers;
+        uint32_t stringsSize;
+    };
+
+    enum NodeKind : uint8_t { FLAG_NODE, GROUP_NODE, ARG_NODE };
+
+    /** A flag, exclusive group or arg; nodes come after the flag holding
+     * them. */
+    struct Node {
+        uint8_t kind;
+        uint8_t policy;
+        uint8_t requestsHelp;
+        uint8_t unused;
+        // index + 1 of the flag holding this node, 0 for the parser itself
+        uint32_t parent;
+        // index + 1 of the exclusive group of a flag, 0 if none
+        uint32_t group;
+        // index into the binding ids, unused by groups
+        uint32_t binding;
+        String name;
+        String description;
+    };
+
+    struct PrintGroup {
+        String name;
+        String description;
+        // node indexes of the flags and args printed by the group
+        uint32_t firstMember;
+        uint32_t numberMembers;
+    };
+
+    static inline const char* magic() { return "AAPS"; }
+};
+
+/**
+ * How ArgParser::loadSchema() recreates the nodes of an image: the converter
+ * of each arg type and the trigger of each flag type, under an id kept in
+ * the image.  Nodes are matched to bindings by their C++ type, so args of
+ * one type share a binding and thus its converter.  Flag and ComplexFlag
+ * without triggers are bound from the start.
+ */
+class SchemaBindings {
+   public:
+    /** Create a node in `store`, the strings are those of the image. */
+    typedef std::function<ParseToken*(FlagStore& store, Policy policy,
+                                      StringView name, StringView description)>
+        Factory;
+
+    struct Binding {
+        std::string id;
+        bool isArg;
+        Factory create;
+    };
+
+   private:
+    std::vector<Binding> bindings;
+    std::unordered_map<std::type_index, size_t> byType;
+    std::unordered_map<std::string, size_t> byId;
+
+    inline void bind(std::type_index type, std::string id, bool isArg,
+                     Factory create) {
+        if (byType.count(type) || byId.count(id)) {
+            AUTOARGPARSE_THROW(std::logic_error(
+                "Binding " + id + " repeats an id or a node type."));
+        }
+        byType.emplace(type, bindings.size());
+        byId.emplace(id, bindings.size());
+        bindings.push_back(Binding{std::move(id), isArg, std::move(create)});
+    }
+
+   public:
+    SchemaBindings() {
+        flag<Flag>("flag");
+        flag<ComplexFlag>("complex_flag");
+    }
+
+    /** Bind the args added as add<ArgType>(..., convert). */
+    template <typename ArgType,
+              typename ConverterFunc = Converter<typename ArgType::ValueType>>
+    SchemaBindings& arg(std::string id,
+                        ConverterFunc convert = ConverterFunc()) {
+        typedef typename ArgType::template WithConverter<ConverterFunc> Node;
+        bind(typeid(Node), std::move(id), true,
+             [convert](FlagStore& store, Policy policy, StringView name,
+                       StringView description) -> ParseToken* {
+                 if (store.schema) {
+                     store.schema->countConverter(
+                         detail::storedSize<ConverterFunc>());
+                 }
+                 return store.create<Node>(name, policy, description,
+                                           ConverterFunc(convert));
+             });
+        return *this;
+    }
+
+    /** Bind the flags added as add<FlagType>(..., trigger). */
+    template <template <class T> class FlagType,
+              typename OnParseTrigger = DoNothingTrigger>
+    SchemaBindings& flag(std::string id,
+                         OnParseTrigger trigger = OnParseTrigger()) {
+        typedef FlagType<OnParseTrigger> Node;
+        bind(typeid(Node), std::move(id), false,
+             [trigger](FlagStore& store, Policy policy, StringView,
+                       StringView description) -> ParseToken* {
+                 return store.create<Node>(policy, description,
+                                           OnParseTrigger(trigger));
+             });
+        return *this;
+    }
+
+    /** The binding of the type of `node`, NULL if there is none. */
+    inline const Binding* find(const ParseToken& node) const {
+        auto found = byType.find(typeid(node));
+        return (found != byType.end()) ? &bindings[found->second] : NULL;
+    }
+
+    inline const Binding* find(const std::string& id) const {
+        auto found = byId.find(id);
+        return (found != byId.end()) ? &bindings[found->second] : NULL;
+    }
+};
+}  // namespace AutoArgParse
+#endif /* AUTOARGPARSE_SCHEMAIMAGE_H_ */
@@ -0,0 +1,564 @@
+/**This file contains StaticSchema, a command line schema declared entirely at
+ compile time.  Flag names are looked up through a perfect hash table computed
+ by the compiler and parsed values are stored in a statically typed tuple, so
+ neither declaring nor parsing a StaticSchema allocates.  Requires C++14.*/
+
+#ifndef AUTOARGPARSE_STATICSCHEMA_H_
+#define AUTOARGPARSE_STATICSCHEMA_H_
+#if __cplusplus < 201402L
+#error "autoArgParse/staticSchema.h requires C++14 or later."
+#endif
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include "argParser.h"
+#include "parseException.h"
+
+namespace AutoArgParse {
+
+enum StaticTokenKind {
+    STATIC_FLAG,    // a flag on its own, e.g. --verbose
+    STATIC_OPTION,  // a flag followed by one value, e.g. --threads 4
+    STATIC_ARG      // a positional argument
+};
+
+namespace detail {
+constexpr size_t constexprLength(const char* str) {
+    size_t length = 0;
+    while (str[length] != '\0') {
+        ++length;
+    }
+    return length;
+}
+
+/** FNV-1a, usable both at compile time and on tokens at run time. */
+constexpr uint64_t staticHash(const char* data, size_t size) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/** Slot of a key in a bucket displaced by `displacement`. */
+constexpr size_t staticSlot(uint64_t hash, uint32_t displacement,
+                            size_t mask) {
+    uint64_t x = hash + displacement * 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return static_cast<size_t>(x ^ (x >> 31)) & mask;
+}
+
+constexpr bool constexprEqual(const char* a, size_t aSize, const char* b,
+                              size_t bSize) {
+    if (aSize != bSize) {
+        return false;
+    }
+    for (size_t i = 0; i < aSize; i++) {
+        if (a[i] != b[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr size_t nextPowerOfTwo(size_t value) {
+    size_t power = 1;
+    while (power < value) {
+        power *= 2;
+    }
+    return power;
+}
+
+// Reaching one of these while the compiler evaluates a StaticSchema makes the
+// declaration ill formed, the function name then appears in the diagnostic.
+inline void staticSchemaError_duplicateFlagName() {
+    AUTOARGPARSE_THROW(
+        std::logic_error("StaticSchema: duplicate flag name."));
+}
+inline void staticSchemaError_noPerfectHashFound() {
+    AUTOARGPARSE_THROW(
+        std::logic_error("StaticSchema: could not build perfect hash."));
+}
+inline void staticSchemaError_unknownFlagName() {
+    AUTOARGPARSE_THROW(
+        std::logic_error("StaticSchema: unknown flag name."));
+}
+
+/** Number of specs that are looked up by name, i.e. not positional. */
+template <typename... Specs>
+constexpr size_t countNamed() {
+    const StaticTokenKind kinds[] = {Specs::kind...};
+    size_t count = 0;
+    for (StaticTokenKind kind : kinds) {
+        count += (kind != STATIC_ARG);
+    }
+    return count;
+}
+
+template <typename T>
+inline bool assignStaticValue(T& value, StringView token,
+                              ConversionError& error, std::false_type) {
+    Converter<T> convert;
+    ConversionResult<T> converted = AutoArgParse::tryConvert(convert, token);
+    if (!converted) {
+        error = std::move(converted.error);
+        return false;
+    }
+    value = std::move(converted.value);
+    return true;
+}
+
+/** Flags have no value to convert, they store whether they were given. */
+inline bool assignStaticValue(bool& value, StringView, ConversionError&,
+                              std::true_type) {
+    value = true;
+    return true;
+}
+}  // namespace detail
+
+/**
+ * Compile time description of one flag, option or positional argument.  Use
+ * staticFlag(), staticOption<T>() and staticArg<T>() to create these.
+ */
+template <typename T, StaticTokenKind Kind>
+struct StaticSpec {
+    typedef T ValueType;
+    static constexpr StaticTokenKind kind = Kind;
+    const char* name;
+    size_t nameLength;
+    Policy policy;
+    const char* description;
+
+    constexpr StaticSpec(const char* name, Policy policy,
+                         const char* description)
+        : name(name),
+          nameLength(detail::constexprLength(name)),
+          policy(policy),
+          description(description) {}
+};
+
+constexpr StaticSpec<bool, STATIC_FLAG> staticFlag(const char* name,
+                                                   Policy policy,
+                                                   const char* description) {
+    return StaticSpec<bool, STATIC_FLAG>(name, policy, description);
+}
+
+template <typename T>
+constexpr StaticSpec<T, STATIC_OPTION> staticOption(const char* name,
+                                                    Policy policy,
+                                                    const char* description) {
+    return StaticSpec<T, STATIC_OPTION>(name, policy, description);
+}
+
+template <typename T>
+constexpr StaticSpec<T, STATIC_ARG> staticArg(const char* name, Policy policy,
+                                              const char* description) {
+    return StaticSpec<T, STATIC_ARG>(name, policy, description);
+}
+
+template <typename... Specs>
+class StaticSchema;
+
+/**
+ * Values parsed against a StaticSchema.  Element I corresponds to the Ith
+ * spec given to the schema, flags hold a bool.
+ */
+template <typename... Specs>
+class StaticParseResult {
+    template <typename...>
+    friend class StaticSchema;
+    typedef std::tuple<typename Specs::ValueType...> ValueTuple;
+
+    ValueTuple values;
+    bool parsedSpecs[sizeof...(Specs)] = {};
+    int numberArgsSuccessfullyParsed = 0;
+
+   public:
+    template <size_t I>
+    using ValueType = typename std::tuple_element<I, ValueTuple>::type;
+
+    /** Return whether the Ith flag/option/arg was given. */
+    template <size_t I>
+    inline bool parsed() const {
+        return parsedSpecs[I];
+    }
+
+    template <size_t I>
+    inline ValueType<I>& get() {
+        return std::get<I>(values);
+    }
+
+    template <size_t I>
+    inline const ValueType<I>& get() const {
+        return std::get<I>(values);
+    }
+
+    inline int getNumberArgsSuccessfullyParsed() const {
+        return numberArgsSuccessfullyParsed;
+    }
+};
+
+/**
+ * A flat command line schema built by the compiler.  Declare it constexpr so
+ * that the perfect hash table over its flag names is computed at compile time
+ * and the schema needs no initialisation at start up:
+ *
+ *     constexpr auto cli = makeStaticSchema(
+ *         staticFlag("--verbose", Policy::OPTIONAL, "Print progress."),
+ *         staticOption<int>("--threads", Policy::OPTIONAL, "Threads."),
+ *         staticArg<StringView>("input", Policy::MANDATORY, "Input."));
+ *     auto result = cli.parse(argc, argv);
+ *     int threads = result.get<cli.indexOf("--threads")>();
+ *
+ * Nesting, exclusive groups and triggers are only available through the
+ * runtime ArgParser.
+ */
+template <typename... Specs>
+class StaticSchema {
+   public:
+    typedef StaticParseResult<Specs...> Result;
+    static constexpr size_t size = sizeof...(Specs);
+
+   private:
+    static_assert(sizeof...(Specs) > 0, "StaticSchema may not be empty.");
+
+   public:
+    static constexpr size_t numberNamed = detail::countNamed<Specs...>();
+    static constexpr size_t tableSize =
+        detail::nextPowerOfTwo((numberNamed > 0) ? 2 * numberNamed : 1);
+
+   private:
+    static constexpr size_t tableMask = tableSize - 1;
+    // limit on displacements tried per bucket before giving up
+    static constexpr uint32_t maxDisplacement = 1u << 20;
+
+    const char* names[size];
+    size_t nameLengths[size];
+    const char* descriptions[size];
+    StaticTokenKind kinds[size];
+    Policy policies[size];
+    // positional args in declaration order
+    size_t positionals[size];
+    size_t numberPositionals;
+    size_t minNameLength;
+    size_t maxNameLength;
+    // perfect hash, slots hold spec index + 1, 0 when empty
+    uint32_t displacements[tableSize];
+    size_t slots[tableSize];
+
+    constexpr bool isNamed(size_t i) const { return kinds[i] != STATIC_ARG; }
+
+    constexpr void buildHashTable() {
+        uint64_t hashes[size] = {};
+        // named specs grouped by bucket, bucket b owns
+        // members[bucketStarts[b]..bucketStarts[b + 1])
+        size_t bucketStarts[tableSize + 1] = {};
+        size_t members[size] = {};
+        for (size_t i = 0; i < size; i++) {
+            if (isNamed(i)) {
+                hashes[i] = detail::staticHash(names[i], nameLengths[i]);
+                ++bucketStarts[(hashes[i] & tableMask) + 1];
+            }
+        }
+        size_t largestBucket = 0;
+        for (size_t bucket = 0; bucket < tableSize; bucket++) {
+            size_t bucketSize = bucketStarts[bucket + 1];
+            largestBucket = (bucketSize > largestBucket) ? bucketSize
+                                                         : largestBucket;
+            bucketStarts[bucket + 1] += bucketStarts[bucket];
+        }
+        size_t filled[tableSize] = {};
+        for (size_t i = 0; i < size; i++) {
+            if (isNamed(i)) {
+                size_t bucket = hashes[i] & tableMask;
+                members[bucketStarts[bucket] + filled[bucket]++] = i;
+            }
+        }
+        // place the largest buckets first, they are the hardest to fit
+        for (size_t bucketSize = largestBucket; bucketSize > 0; bucketSize--) {
+            for (size_t bucket = 0; bucket < tableSize; bucket++) {
+                const size_t first = bucketStarts[bucket];
+                const size_t last = bucketStarts[bucket + 1];
+                if (last - first != bucketSize) {
+                    continue;
+                }
+                // identical names hash identically so share a bucket
+                for (size_t i = first; i < last; i++) {
+                    for (size_t j = first; j < i; j++) {
+                        if (detail::constexprEqual(
+                                names[members[i]], nameLengths[members[i]],
+                                names[members[j]], nameLengths[members[j]])) {
+                            detail::staticSchemaError_duplicateFlagName();
+                        }
+                    }
+                }
+                size_t chosen[size] = {};
+                for (uint32_t displacement = 0;; displacement++) {
+                    if (displacement == maxDisplacement) {
+                        detail::staticSchemaError_noPerfectHashFound();
+                    }
+                    bool fits = true;
+                    for (size_t i = first; i < last && fits; i++) {
+                        size_t slot = detail::staticSlot(
+                            hashes[members[i]], displacement, tableMask);
+                        fits = slots[slot] == 0;
+                        for (size_t c = first; c < i && fits; c++) {
+                            fits = chosen[c - first] != slot;
+                        }
+                        chosen[i - first] = slot;
+                    }
+                    if (fits) {
+                        for (size_t i = first; i < last; i++) {
+                            slots[chosen[i - first]] = members[i] + 1;
+                        }
+                        displacements[bucket] = displacement;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    template <size_t I>
+    static bool convertAt(Result& result, StringView token,
+                          ConversionError& error) {
+        typedef typename std::tuple_element<I, std::tuple<Specs...>>::type Spec;
+        return detail::assignStaticValue(
+            std::get<I>(result.values), token, error,
+            std::integral_constant<bool, Spec::kind == STATIC_FLAG>());
+    }
+
+    template <size_t... Is>
+    static bool convert(Result& result, size_t index, StringView token,
+                        ConversionError& error, std::index_sequence<Is...>) {
+        typedef bool (*ConvertFunc)(Result&, StringView, ConversionError&);
+        // constant initialised, costs nothing at start up
+        static constexpr ConvertFunc converters[] = {&convertAt<Is>...};
+        return converters[index](result, token, error);
+    }
+
+    /** Convert token into spec `index` (flags just record that they were
+     * given), false if an optional positional arg rejected it.*/
+    bool tryConvert(Result& result, size_t index, StringView token) const {
+        ConversionError error;
+        if (convert(result, index, token, error,
+                    std::index_sequence_for<Specs...>())) {
+            return true;
+        }
+        if (kinds[index] == STATIC_ARG && policies[index] == Policy::OPTIONAL) {
+            return false;
+        }
+        AUTOARGPARSE_THROW(FailedArgConversionException(
+            (kinds[index] == STATIC_OPTION) ? "value of " + nameOf(index)
+                                            : nameOf(index),
+            error.message()));
+    }
+
+    inline std::string nameOf(size_t index) const {
+        return std::string(names[index], nameLengths[index]);
+    }
+
+    void printOptions(std::ostream& os, const Result& result,
+                      bool positionals) const {
+        for (size_t i = 0; i < size; i++) {
+            if (result.parsedSpecs[i] || isNamed(i) == positionals) {
+                continue;
+            }
+            os << " ";
+            if (policies[i] == Policy::OPTIONAL) {
+                os << "[";
+            }
+            os << nameOf(i);
+            if (policies[i] == Policy::OPTIONAL) {
+                os << "]";
+            }
+        }
+    }
+
+   public:
+    constexpr StaticSchema(const Specs&... specs)
+        : names{specs.name...},
+          nameLengths{specs.nameLength...},
+          descriptions{specs.description...},
+          kinds{Specs::kind...},
+          policies{specs.policy...},
+          positionals{},
+          numberPositionals(0),
+          minNameLength(static_cast<size_t>(-1)),
+          maxNameLength(0),
+          displacements{},
+          slots{} {
+        for (size_t i = 0; i < size; i++) {
+            if (!isNamed(i)) {
+                positionals[numberPositionals++] = i;
+                continue;
+            }
+            minNameLength = (nameLengths[i] < minNameLength) ? nameLengths[i]
+                                                             : minNameLength;
+            maxNameLength = (nameLengths[i] > maxNameLength) ? nameLengths[i]
+                                                             : maxNameLength;
+        }
+        buildHashTable();
+    }
+
+    /** Index of the flag or option called `name`, -1 if there is none. */
+    constexpr int find(StringView name) const {
+        if (name.size() < minNameLength || name.size() > maxNameLength) {
+            return -1;
+        }
+        uint64_t hash = detail::staticHash(name.data(), name.size());
+        size_t slot = slots[detail::staticSlot(
+            hash, displacements[hash & tableMask], tableMask)];
+        if (slot == 0 || !detail::constexprEqual(names[slot - 1],
+                                                 nameLengths[slot - 1],
+                                                 name.data(), name.size())) {
+            return -1;
+        }
+        return static_cast<int>(slot - 1);
+    }
+
+    constexpr int find(const char* name) const {
+        return find(StringView(name, detail::constexprLength(name)));
+    }
+
+    /** Compile time index of the spec called `name`, for use with
+     * StaticParseResult::get<I>().*/
+    constexpr size_t indexOf(const char* name) const {
+        size_t length = detail::constexprLength(name);
+        for (size_t i = 0; i < size; i++) {
+            if (detail::constexprEqual(names[i], nameLengths[i], name,
+                                       length)) {
+                return i;
+            }
+        }
+        detail::staticSchemaError_unknownFlagName();
+        return size;
+    }
+
+    /**
+     * Parse argv against this schema, throws a ParseException on failure.
+     * Does not allocate unless a converter does or parsing fails.
+     */
+    Result parse(const int argc, const char** argv) const {
+        Result result;
+        size_t nextPositional = 0;
+        int i = 1;
+        for (; i < argc; i++) {
+            result.numberArgsSuccessfullyParsed = i;
+            StringView token(argv[i]);
+            int index = find(token);
+            if (index >= 0) {
+                if (result.parsedSpecs[index]) {
+                    AUTOARGPARSE_THROW(RepeatedFlagException(token));
+                }
+                if (kinds[index] == STATIC_OPTION) {
+                    if (i + 1 == argc) {
+                        result.numberArgsSuccessfullyParsed = i + 1;
+                        AUTOARGPARSE_THROW(ParseException(
+                            MISSING_MANDATORY_ARG,
+                            "Missing mandatory argument(s).  Valid option(s) "
+                            "are:  value of " +
+                                nameOf(index)));
+                    }
+                    tryConvert(result, index, StringView(argv[++i]));
+                } else {
+                    tryConvert(result, index, token);
+                }
+                result.parsedSpecs[index] = true;
+                continue;
+            }
+            bool converted = false;
+            while (!converted && nextPositional < numberPositionals) {
+                size_t positional = positionals[nextPositional++];
+                converted = tryConvert(result, positional, token);
+                result.parsedSpecs[positional] = converted;
+            }
+            if (!converted) {
+                std::ostringstream os;
+                os << "Unexpected argument: " << token << std::endl;
+                os << "Valid option(s): ";
+                printOptions(os, result, false);
+                printOptions(os, result, true);
+                AUTOARGPARSE_THROW(ParseException(UNEXPECTED_ARG, os.str()));
+            }
+        }
+        result.numberArgsSuccessfullyParsed = i;
+        for (size_t spec = 0; spec < size; spec++) {
+            if (policies[spec] == Policy::MANDATORY &&
+                !result.parsedSpecs[spec]) {
+                std::ostringstream os;
+                os << "Missing mandatory argument(s). valid option(s) are: ";
+                printOptions(os, result, !isNamed(spec));
+                AUTOARGPARSE_THROW(
+                    ParseException((isNamed(spec)) ? MISSING_MANDATORY_FLAG
+                                                   : MISSING_MANDATORY_ARG,
+                                   os.str()));
+            }
+        }
+        return result;
+    }
+
+    void printUsageHelp(std::ostream& os,
+                        const std::string& programName) const {
+        os << "Usage: " << programName;
+        for (size_t i = 0; i < size; i++) {
+            os << " ";
+            if (policies[i] == Policy::OPTIONAL) {
+                os << "[";
+            }
+            os << nameOf(i);
+            if (kinds[i] == STATIC_OPTION) {
+                os << " value";
+            }
+            if (policies[i] == Policy::OPTIONAL) {
+                os << "]";
+            }
+        }
+        os << "\n\nArguments:\n";
+        IndentedLine lineIndent(1);
+        for (size_t i = 0; i < size; i++) {
+            os << lineIndent << nameOf(i);
+            if (policies[i] == Policy::OPTIONAL) {
+                os << " [optional]";
+            }
+            os << ": " << descriptions[i];
+        }
+        os << "\n";
+    }
+
+    /**
+     * Same behaviour as ArgParser::validateArgs(), on error print the error
+     * and usage then exit.
+     */
+    Result validateArgs(const int argc, const char** argv,
+                        bool handleError = true) const {
+#if AUTOARGPARSE_EXCEPTIONS
+        try {
+            return parse(argc, argv);
+        } catch (ParseException& e) {
+            if (!handleError) {
+                throw;
+            }
+            std::cerr << "Error: " << e.what() << std::endl;
+            printUsageHelp(std::cerr, argv[0]);
+            exit(1);
+        }
+#else
+        // errors abort in parse(), see AUTOARGPARSE_THROW
+        (void)handleError;
+        return parse(argc, argv);
+#endif
+    }
+};
+
+template <typename... Specs>
+constexpr StaticSchema<Specs...> makeStaticSchema(const Specs&... specs) {
+    return StaticSchema<Specs...>(specs...);
+}
+}  // namespace AutoArgParse
+#endif /* AUTOARGPARSE_STATICSCHEMA_H_ */
@@ -0,0 +1,67 @@
+#ifndef AUTOARGPARSE_STRINGPOOL_H_
+#define AUTOARGPARSE_STRINGPOOL_H_
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "arena.h"
+#include "stringView.h"
+namespace AutoArgParse {
+
+/**
+ * Interns the names and descriptions of a schema: each distinct string is
+ * copied into the arena once and every later copy of it refers to that one.
+ * Generated command line tools repeat the same option names and descriptions
+ * under many subcommands, those then cost a pointer each.
+ */
+class StringPool {
+    Arena* arena;
+    std::vector<StringView> strings;
+    // index + 1 into strings of each slot, 0 if empty; at most half full
+    std::vector<uint32_t> slots;
+
+    inline void insertSlot(size_t index) {
+        size_t mask = slots.size() - 1;
+        size_t slot = StringViewHash()(strings[index]) & mask;
+        while (slots[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = static_cast<uint32_t>(index + 1);
+    }
+
+   public:
+    explicit StringPool(Arena* arena) : arena(arena) {}
+
+    /** The copy of `str` held by the arena, made on first use. */
+    inline StringView intern(StringView str) {
+        if (!slots.empty()) {
+            size_t mask = slots.size() - 1;
+            for (size_t slot = StringViewHash()(str) & mask; slots[slot] != 0;
+                 slot = (slot + 1) & mask) {
+                if (strings[slots[slot] - 1] == str) {
+                    return strings[slots[slot] - 1];
+                }
+            }
+        }
+        strings.push_back(arena->copy(str));
+        if (strings.size() * 2 <= slots.size()) {
+            insertSlot(strings.size() - 1);
+        } else {
+            slots.assign(std::max<size_t>(16, slots.size() * 2), 0);
+            for (size_t i = 0; i < strings.size(); i++) {
+                insertSlot(i);
+            }
+        }
+        return strings.back();
+    }
+
+    /** Number of distinct strings. */
+    inline size_t size() const { return strings.size(); }
+
+    /** Heap memory held by the table, the strings are in the arena. */
+    inline size_t bytesUsed() const {
+        return strings.capacity() * sizeof(StringView) +
+               slots.capacity() * sizeof(uint32_t);
+    }
+};
+}  // namespace AutoArgParse
+#endif /* AUTOARGPARSE_STRINGPOOL_H_ */
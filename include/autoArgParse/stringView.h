@@ -0,0 +1,98 @@
+#ifndef AUTOARGPARSE_STRINGVIEW_H_
+#define AUTOARGPARSE_STRINGVIEW_H_
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+namespace AutoArgParse {
+
+/**
+ * Non owning, read only view of a sequence of characters.  Used to refer to
+ * command line tokens in place (e.g. directly inside argv) rather than copying
+ * each of them into a std::string.  A StringView implicitly converts to
+ * std::string, so converters and triggers written against `const
+ * std::string&` keep working, the copy is then only made when such a function
+ * is actually called.
+ */
+class StringView {
+    const char* _data;
+    size_t _size;
+
+   public:
+    static const size_t npos = static_cast<size_t>(-1);
+
+    constexpr StringView() : _data(""), _size(0) {}
+    constexpr StringView(const char* data, size_t size)
+        : _data(data), _size(size) {}
+    StringView(const char* str) : _data(str), _size(strlen(str)) {}
+    StringView(const std::string& str)
+        : _data(str.data()), _size(str.size()) {}
+
+    constexpr const char* data() const { return _data; }
+    constexpr size_t size() const { return _size; }
+    constexpr size_t length() const { return _size; }
+    constexpr bool empty() const { return _size == 0; }
+    constexpr const char* begin() const { return _data; }
+    constexpr const char* end() const { return _data + _size; }
+    constexpr char operator[](size_t i) const { return _data[i]; }
+    constexpr char front() const { return _data[0]; }
+    constexpr char back() const { return _data[_size - 1]; }
+
+    inline StringView substr(size_t pos, size_t count = npos) const {
+        pos = std::min(pos, _size);
+        return StringView(_data + pos, std::min(count, _size - pos));
+    }
+
+    inline size_t find(char c, size_t pos = 0) const {
+        if (pos >= _size) {
+            return npos;
+        }
+        const void* found = memchr(_data + pos, c, _size - pos);
+        return (found) ? static_cast<const char*>(found) - _data : npos;
+    }
+
+    inline bool startsWith(StringView prefix) const {
+        return _size >= prefix._size &&
+               memcmp(_data, prefix._data, prefix._size) == 0;
+    }
+
+    inline int compare(StringView other) const {
+        int result = memcmp(_data, other._data, std::min(_size, other._size));
+        if (result != 0) {
+            return result;
+        }
+        return (_size < other._size) ? -1 : (_size > other._size) ? 1 : 0;
+    }
+
+    /** Copy the viewed characters into an owning string. */
+    inline std::string str() const { return std::string(_data, _size); }
+    inline operator std::string() const { return str(); }
+
+    friend inline bool operator==(StringView a, StringView b) {
+        return a._size == b._size && memcmp(a._data, b._data, a._size) == 0;
+    }
+    friend inline bool operator!=(StringView a, StringView b) {
+        return !(a == b);
+    }
+    friend inline bool operator<(StringView a, StringView b) {
+        return a.compare(b) < 0;
+    }
+    friend inline std::ostream& operator<<(std::ostream& os, StringView view) {
+        return os.write(view._data, view._size);
+    }
+};
+
+/** FNV-1a hash, lets unordered containers be keyed and searched by view. */
+struct StringViewHash {
+    inline size_t operator()(StringView view) const {
+        uint64_t hash = 14695981039346656037ULL;
+        for (char c : view) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ULL;
+        }
+        return static_cast<size_t>(hash);
+    }
+};
+}  // namespace AutoArgParse
+#endif /* AUTOARGPARSE_STRINGVIEW_H_ */
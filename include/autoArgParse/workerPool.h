@@ -0,0 +1,120 @@
+#ifndef AUTOARGPARSE_WORKERPOOL_H_
+#define AUTOARGPARSE_WORKERPOOL_H_
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+namespace AutoArgParse {
+namespace detail {
+
+/**
+ * A fixed pool of threads, the calling thread included, running one indexed
+ * task at a time for BatchParser and ConversionPool.  Indexes are claimed in
+ * chunks through an atomic counter, so the threads only synchronise when a
+ * task starts and when it ends.
+ */
+class WorkerPool {
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable taskReady;
+    std::condition_variable taskDone;
+    size_t generation = 0;
+    size_t busyWorkers = 0;
+    bool stopping = false;
+
+    // the task being run, set before generation is incremented
+    const std::function<void(size_t)>* task = NULL;
+    size_t taskSize = 0;
+    size_t chunkSize = 1;
+    std::atomic<size_t> nextIndex;
+
+    inline void runChunks() {
+        while (true) {
+            size_t begin =
+                nextIndex.fetch_add(chunkSize, std::memory_order_relaxed);
+            if (begin >= taskSize) {
+                return;
+            }
+            size_t end = std::min(begin + chunkSize, taskSize);
+            for (size_t i = begin; i < end; i++) {
+                (*task)(i);
+            }
+        }
+    }
+
+    inline void work() {
+        size_t seenGeneration = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                taskReady.wait(lock, [&]() {
+                    return stopping || generation != seenGeneration;
+                });
+                if (stopping) {
+                    return;
+                }
+                seenGeneration = generation;
+            }
+            runChunks();
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--busyWorkers == 0) {
+                taskDone.notify_one();
+            }
+        }
+    }
+
+   public:
+    /** Zero threads means one per hardware thread. */
+    explicit WorkerPool(unsigned numberThreads) : nextIndex(0) {
+        if (numberThreads == 0) {
+            numberThreads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        for (unsigned i = 1; i < numberThreads; i++) {
+            workers.emplace_back([this]() { work(); });
+        }
+    }
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        taskReady.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    inline size_t numberThreads() const { return workers.size() + 1; }
+
+    /**
+     * Call task(i) for every i < size, in no particular order, the threads
+     * claiming `chunkSize` indexes at a time.  Returns once all calls have
+     * returned.  `task` must not throw, and only one thread at a time may
+     * run tasks.
+     */
+    inline void runIndexed(size_t size, size_t chunkSize,
+                           const std::function<void(size_t)>& task) {
+        this->task = &task;
+        taskSize = size;
+        this->chunkSize = std::max<size_t>(1, chunkSize);
+        nextIndex.store(0, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            busyWorkers = workers.size();
+            ++generation;
+        }
+        taskReady.notify_all();
+        runChunks();
+        std::unique_lock<std::mutex> lock(mutex);
+        taskDone.wait(lock, [&]() { return busyWorkers == 0; });
+    }
+};
+}  // namespace detail
+}  // namespace AutoArgParse
+#endif /* AUTOARGPARSE_WORKERPOOL_H_ */